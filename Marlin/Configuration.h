@@ -57,6 +57,18 @@
 //#define ANYCUBIC_TFT_DEBUG
 //#define POWER_OUTAGE_TEST
 
+/*
+ * Send output to the TFT from a larger queue. Menu texts
+ * are queued by reference instead of being copied, and new
+ * TFT commands wait until their longest reply fits instead of
+ * the printer waiting on the serial port. M942 reports stalls.
+ */
+//#define ANYCUBIC_TFT_TX_QUEUE
+#if ENABLED(ANYCUBIC_TFT_TX_QUEUE)
+  #define TFT_TX_BUFFER_SIZE 256  // Bytes (power of 2, up to 256)
+  #define TFT_TX_PGM_QUEUE    16  // Texts queued by reference (power of 2)
+#endif
+
 #define EXT_LEVEL_HIGH 0.1
 
 /*
@@ -1693,6 +1705,13 @@
   #define SEGMENT_LEVELED_MOVES
   #define LEVELED_SEGMENT_LENGTH 5.0 // (mm) Length of all segments (except the last one)
 
+  // Size segments from the shape of the mesh instead, so moves over a flat
+  // bed are split less. LEVELED_SEGMENT_LENGTH becomes the minimum length.
+  //#define LEVELED_SEGMENT_ADAPTIVE
+  #if ENABLED(LEVELED_SEGMENT_ADAPTIVE)
+    #define LEVELED_SEGMENT_TOLERANCE 0.01 // (mm) Allowed Z deviation from the mesh
+  #endif
+
   /**
    * Enable the G26 Mesh Validation Pattern tool.
    */
@@ -1733,6 +1752,14 @@
       #define BILINEAR_SUBDIVISIONS 3
     #endif
 
+    //
+    // Precompute bilinear coefficients for each grid cell in a fixed-point
+    // table, so leveling a segment costs a table lookup and a few integer
+    // multiplies instead of float FLOOR and interpolation. Resolution is
+    // 1µm in Z. Uses 8 bytes of SRAM per grid cell.
+    //
+    //#define ABL_BILINEAR_CELL_TABLE
+
   #endif
 
 #elif ENABLED(AUTO_BED_LEVELING_UBL)
@@ -1917,6 +1944,10 @@
 //#define EEPROM_BOOT_SILENT    // Keep M503 quiet and only give errors during first load
 #if ENABLED(EEPROM_SETTINGS)
   #define EEPROM_AUTO_INIT  // Init EEPROM automatically on any errors.
+  //#define EEPROM_ASYNC_SAVE // Write only changed bytes, in the background, so M500 doesn't stall motion
+  #if ENABLED(EEPROM_ASYNC_SAVE)
+    #define EEPROM_ASYNC_SAVE_BYTES 64 // Changed bytes that can be queued. Larger saves are written immediately.
+  #endif
 #endif
 
 //
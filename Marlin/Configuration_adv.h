@@ -791,6 +791,22 @@
 // if unwanted behavior is observed on a user's machine when running at very slow speeds.
 #define MINIMUM_PLANNER_SPEED 0.05 // (mm/s)
 
+/**
+ * Fixed-point planner kernels. The planner recalculates the speed profile of every
+ * changed block each time a move is queued. This does it with integer entry and exit
+ * step rates, so there's no soft-float division or square root per block on MCUs
+ * without an FPU, only a float multiply per rate. New moves also get their length
+ * from an integer square root, and junction deviation limits the acceleration
+ * without a division per axis. It's not a float-free planner: junction speeds and
+ * the rest of the move setup stay float, Linear Advance blocks still take float
+ * square roots, and blocks faster than 65535 steps/s use the float path.
+ * Check accuracy with buildroot/share/scripts/fixed_point_test.py.
+ */
+//#define PLANNER_FIXED_POINT
+#if ENABLED(PLANNER_FIXED_POINT)
+  //#define PLANNER_FIXED_POINT_CHECK // Also run the float path and report the largest difference with M941
+#endif
+
 //
 // Backlash Compensation
 // Adds extra movement to axes on direction-changes to account for backlash.
@@ -1092,6 +1108,13 @@
     // Without a POWER_LOSS_PIN the following option helps reduce wear on the SD card,
     // especially with "vase mode" printing. Set too high and vases cannot be continued.
     #define POWER_LOSS_MIN_Z_CHANGE 0.05 // (mm) Minimum Z change before saving power-loss data
+
+    // Keep the recovery file as a journal of contiguous blocks, written in turn with
+    // one raw block write per save. No FAT or directory updates happen while printing.
+    //#define POWER_LOSS_JOURNAL
+    #if ENABLED(POWER_LOSS_JOURNAL)
+      #define POWER_LOSS_JOURNAL_BLOCKS 32 // Blocks (512 bytes each) that saves rotate through
+    #endif
   #endif
 
   /**
@@ -1132,6 +1155,17 @@
                                       // Note: Only affects SCROLL_LONG_FILENAMES with SDSORT_CACHE_NAMES but not SDSORT_DYNAMIC_RAM.
   #endif
 
+  /**
+   * Keep the directory position of each item in the current folder so that
+   * file lists can be paged without reading the folder from the start for
+   * every item. Items past SD_DIR_INDEX_SIZE are read on from the last one.
+   * Costs 2 bytes per item.
+   */
+  //#define SD_DIR_INDEX
+  #if ENABLED(SD_DIR_INDEX)
+    #define SD_DIR_INDEX_SIZE 128   // Maximum number of indexed items
+  #endif
+
   // This allows hosts to request long names for files and folders with M33
   //#define LONG_FILENAME_HOST_SUPPORT
 
@@ -1160,6 +1194,39 @@
    */
   //#define AUTO_REPORT_SD_STATUS
 
+  /**
+   * Print heatshrink-compressed G-code files (*.gcz) directly from the card.
+   * The file is decompressed in small chunks as it is read, so it takes less
+   * card space and less SPI bandwidth than the plain file. Compress with
+   * window size 8 and lookahead 4 (buildroot/share/scripts/gcz.py).
+   * Seeking (M26, resume after a sub-procedure) decodes from the file start.
+   * Requires ~340 bytes of RAM.
+   */
+  //#define SD_COMPRESSED_GCODE
+
+  /**
+   * Print binary G-code files (*.gcb) made by buildroot/share/scripts/gcb.py.
+   * G0-G3 moves are stored as compact delta-encoded records that go into the
+   * command queue as parser tokens, skipping text parsing. Other commands are
+   * kept as text. Requires GCODE_QUEUE_TOKENS.
+   */
+  //#define SD_BINARY_GCODE
+
+  /**
+   * Read the file being printed a block ahead. The main loop loads the next
+   * block while commands are still queued, so fetching G-code rarely waits
+   * on the card, and contiguous cluster chains are cached to skip most FAT
+   * reads. Requires about 530 bytes of RAM.
+   */
+  //#define SD_READ_AHEAD
+
+  /**
+   * Take G-code lines from the read-ahead block in one pass instead of
+   * fetching each byte on its own. Comments are skipped without looking at
+   * every character. Requires SD_READ_AHEAD.
+   */
+  //#define SD_BATCH_READ
+
   /**
    * Support for USB thumb drives using an Arduino USB Host Shield or
    * equivalent MAX3421E breakout board. The USB thumb drive will appear
@@ -1718,6 +1785,38 @@
  */
 //#define MAXIMUM_STEPPER_RATE 250000
 
+/**
+ * Step timer interval without a division. 32-bit boards divide the timer rate
+ * by the step rate each time the stepper ISR changes speed, which is a slow
+ * library call on MCUs without a divide instruction (Cortex-M0). AVR always
+ * uses speed_lookuptable.h.
+ *
+ *  STEP_TIMER_TABLE      : Interpolate a table of reciprocals built at compile time
+ *  STEP_TIMER_RECIPROCAL : Also refine it with one Newton-Raphson step, within 1 tick at 64 entries
+ *
+ * buildroot/share/scripts/step_timer_test.py checks both against the division on the host.
+ */
+//#define STEP_TIMER_TABLE
+//#define STEP_TIMER_RECIPROCAL
+#if EITHER(STEP_TIMER_TABLE, STEP_TIMER_RECIPROCAL)
+  #define STEP_TIMER_TABLE_SIZE 64  // 16, 64 or 256 entries. The table alone is within 100 ppm at 64, 1 tick at 256.
+  //#define STEP_TIMER_CHECK        // Also divide and report the largest difference with M940 (Requires STEPPER_ISR_PROFILE)
+#endif
+
+/**
+ * Step Timing Queue
+ *
+ * Work out the step intervals of the running block from idle(), ahead of the
+ * stepper ISR, and keep them as runs of (interval, count, delta). The ISR then
+ * takes the next interval instead of evaluating the acceleration curve, which
+ * shortens it and makes it more even. When the main loop falls behind and the
+ * queue runs dry the ISR works the interval out itself, as without this option.
+ */
+//#define STEP_TIMING_QUEUE
+#if ENABLED(STEP_TIMING_QUEUE)
+  #define STEP_TIMING_QUEUE_SIZE 16 // Runs. A power of 2 from 2 to 128.
+#endif
+
 // @section temperature
 
 // Control heater 0 and heater 1 in parallel.
@@ -1737,6 +1836,15 @@
   #define BLOCK_BUFFER_SIZE 16 // maximize block buffer
 #endif
 
+// Size the block buffer at startup from the RAM left after static allocation.
+// BLOCK_BUFFER_SIZE becomes the minimum and the buffer doubles up to
+// BLOCK_BUFFER_SIZE_MAX while BLOCK_BUFFER_RAM_RESERVE bytes stay free for the stack.
+//#define BLOCK_BUFFER_AUTO_SIZE
+#if ENABLED(BLOCK_BUFFER_AUTO_SIZE)
+  #define BLOCK_BUFFER_SIZE_MAX     64
+  #define BLOCK_BUFFER_RAM_RESERVE 1536 // (bytes)
+#endif
+
 // @section serial
 
 // The ASCII buffer for serial input
@@ -2820,6 +2928,7 @@
 
 #if ENABLED(FASTER_GCODE_PARSER)
   //#define GCODE_QUOTED_STRINGS  // Support for quoted string parameters
+  //#define GCODE_QUEUE_TOKENS    // Convert G0-G3 parameters to binary when queued, not when run. Costs BUFSIZE bytes of SRAM.
 #endif
 
 //#define GCODE_CASE_INSENSITIVE  // Accept G-code sent to the firmware in lowercase
@@ -3160,5 +3269,62 @@
 // Enable Marlin dev mode which adds some special commands
 //#define MARLIN_DEV_MODE
 
+//
+// M940 - Profile the stepper ISR. Each phase (pulse, advance, babystep, block)
+// is timed with the stepper timer into a cycle histogram, along with the
+// multistepping level and the number of times the ISR loop guard gave up.
+// Use it to see what limits the step rate on dense curved moves.
+//
+//#define STEPPER_ISR_PROFILE
+
+//
+// M941 - Count the blocks visited by the planner look-ahead for each queued block
+//
+//#define PLANNER_LOOKAHEAD_STATS
+
+//
+// M941 - Count the times the stepper finds the planner buffer empty during a
+// print, how long it stayed empty, the fewest moves queued when a block was
+// taken, and the G-code line being processed at the longest underrun. Waits
+// the G-code asks for (M400, G4, M109, M190...) aren't counted.
+//
+//#define PLANNER_UNDERRUN_STATS
+
+//
+// M943 - Run the idle() tasks from a cooperative scheduler. Each task runs when
+// its period is up and it has work to do, and its run time is measured. While
+// the planner is running low, background tasks wait so the G-code parser and
+// the planner get the time.
+//
+//#define IDLE_TASK_SCHEDULER
+#if ENABLED(IDLE_TASK_SCHEDULER)
+  #define IDLE_TASK_MAX_DEFER 250 // (ms) Longest a background task is held back for a low planner buffer
+#endif
+
+//
+// M944 - Time each step of the main loop (command reading, queue advance, heaters,
+// UI, TFT scan, SD read-ahead) and keep the longest and average call and the lowest
+// planner fill seen. Use it to find which task lets the planner run dry when prints
+// stutter. Deliberate waits (M400, G4, M109, homing) aren't counted, and the queue
+// advance step includes the command it runs. M944 S<seconds> reports it periodically.
+//
+//#define LOOP_LATENCY_TRACE
+
+//
+// Run the linux_native simulator on a virtual clock. Timer ISRs fire at their
+// programmed compare ticks without sleeping, so a whole G-code file piped into
+// stdin replays in seconds with identical results on every run.
+//
+//#define LINUX_VIRTUAL_CLOCK
+#if ENABLED(LINUX_VIRTUAL_CLOCK)
+  //
+  // Measure planner / stepper throughput during the replay. Blocks/s, steps/s
+  // and the p50/p99 host cost of each ISR call are written as JSON on exit.
+  // Use buildroot/share/scripts/linux_benchmark.py to run a G-code corpus.
+  //
+  //#define LINUX_BENCHMARK
+  #define LINUX_BENCHMARK_FILE "benchmark.json"
+#endif
+
 //#define KNUTWURST_MEGAS_ADV
 //#define KNUTWURST_TMC_ADV
@@ -106,3 +106,9 @@ inline uint8_t HAL_get_reset_source(void) { return RST_POWER_ON; }
 FORCE_INLINE static void DELAY_CYCLES(uint64_t x) {
   Clock::delayCycles(x);
 }
+
+#if ENABLED(LINUX_VIRTUAL_CLOCK)
+  // Step the virtual clock and the simulated peripherals from idle()
+  #define HAL_IDLETASK 1
+  void HAL_idletask();
+#endif
@@ -37,9 +37,20 @@ void _delay_ms(const int delay_ms) {
 }
 
 uint32_t millis() {
+  #if ENABLED(LINUX_VIRTUAL_CLOCK)
+    // Reading the clock costs time, so busy-wait loops still make progress
+    Clock::advance(1000);
+  #endif
   return (uint32_t)Clock::millis();
 }
 
+uint32_t micros() {
+  #if ENABLED(LINUX_VIRTUAL_CLOCK)
+    Clock::advance(1000);
+  #endif
+  return (uint32_t)Clock::micros();
+}
+
 // This is required for some Arduino libraries we are using
 void delayMicroseconds(uint32_t us) {
   Clock::delayMicros(us);
@@ -0,0 +1,133 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef __PLAT_LINUX__
+
+#include "../../../inc/MarlinConfig.h"
+
+#if ENABLED(LINUX_BENCHMARK)
+
+#include "Benchmark.h"
+#include "../../../module/planner.h"
+
+#include <fstream>
+
+Benchmark::host_clock::time_point Benchmark::started;
+Benchmark::isr_stats_t Benchmark::isr_cost[2];
+uint64_t Benchmark::isr_total_ns, Benchmark::commands, Benchmark::blocks;
+uint8_t Benchmark::last_tail;
+
+static uint16_t bucket_of(uint64_t ns) {
+  NOMORE(ns, 0xFFFFFFFFULL);
+  if (ns < Benchmark::LINEAR_NS) return ns;
+  uint8_t e = Benchmark::LINEAR_BITS;             // ns is in [2^e, 2^(e+1))
+  while (ns >> (e + 1)) e++;
+  return Benchmark::LINEAR_NS + (e - Benchmark::LINEAR_BITS) * Benchmark::SUB_BUCKETS
+       + ((ns >> (e - Benchmark::SUB_BITS)) & (Benchmark::SUB_BUCKETS - 1));
+}
+
+// The middle of a bucket, in ns
+static uint64_t bucket_ns(const uint16_t b) {
+  if (b < Benchmark::LINEAR_NS) return b;
+  const uint8_t e = Benchmark::LINEAR_BITS + (b - Benchmark::LINEAR_NS) / Benchmark::SUB_BUCKETS,
+                sub = (b - Benchmark::LINEAR_NS) % Benchmark::SUB_BUCKETS;
+  const uint64_t width = 1ULL << (e - Benchmark::SUB_BITS);
+  return (1ULL << e) + sub * width + width / 2;
+}
+
+void Benchmark::isrEnd(const uint8_t timer_id, const host_clock::time_point &begin) {
+  const uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(host_clock::now() - begin).count();
+  isr_total_ns += ns;
+  if (timer_id < COUNT(isr_cost)) {
+    isr_stats_t &s = isr_cost[timer_id];
+    s.calls++;
+    s.total_ns += ns;
+    NOLESS(s.max_ns, ns);
+    s.histogram[bucket_of(ns)]++;
+  }
+
+  // Blocks are retired by the stepper ISR, so count them as the tail moves
+  if (timer_id == STEP_TIMER_NUM) {
+    const uint8_t tail = planner.block_buffer_tail;
+    blocks += BLOCK_MOD(tail - last_tail);
+    last_tail = tail;
+  }
+}
+
+static uint64_t percentile(const Benchmark::isr_stats_t &s, const uint8_t p) {
+  if (!s.calls) return 0;
+  const uint64_t n = (s.calls - 1) * p / 100;     // Index of the sample in sorted order
+  uint64_t seen = 0;
+  for (uint16_t b = 0; b < Benchmark::BUCKETS; b++) {
+    seen += s.histogram[b];
+    if (seen > n) return _MIN(bucket_ns(b), s.max_ns);
+  }
+  return s.max_ns;
+}
+
+static void report_isr(std::ofstream &out, const char * const name, const Benchmark::isr_stats_t &s) {
+  out << "  \"" << name << "\": {"
+      << " \"calls\": " << s.calls
+      << ", \"mean_ns\": " << (s.calls ? s.total_ns / s.calls : 0)
+      << ", \"p50_ns\": " << percentile(s, 50)
+      << ", \"p99_ns\": " << percentile(s, 99)
+      << ", \"max_ns\": " << s.max_ns
+      << " },\n";
+}
+
+bool Benchmark::report(const std::string &filename, const double virtual_seconds, const uint64_t steps) {
+  const double host_seconds = std::chrono::duration<double>(host_clock::now() - started).count();
+
+  std::ofstream out(filename);
+  if (!out) return false;
+
+  out << "{\n"
+      << "  \"virtual_s\": " << virtual_seconds << ",\n"
+      << "  \"host_s\": " << host_seconds << ",\n"
+      << "  \"main_loop_s\": " << host_seconds - isr_total_ns / 1e9 << ",\n"
+      << "  \"commands\": " << commands << ",\n"
+      << "  \"blocks\": " << blocks << ",\n"
+      << "  \"steps\": " << steps << ",\n"
+      << "  \"commands_per_s\": " << commands / host_seconds << ",\n"
+      << "  \"blocks_per_s\": " << blocks / host_seconds << ",\n"
+      << "  \"steps_per_s\": " << steps / host_seconds << ",\n";
+  report_isr(out, "stepper_isr", isr_cost[STEP_TIMER_NUM]);
+  report_isr(out, "temperature_isr", isr_cost[TEMP_TIMER_NUM]);
+  #if ENABLED(PLANNER_LOOKAHEAD_STATS)
+    const lookahead_stats_t &la = planner.lookahead_stats;
+    out << "  \"lookahead_per_append\": " << (la.appends ? double(la.blocks_touched) / la.appends : 0) << ",\n"
+        << "  \"lookahead_max\": " << int(la.max_touched) << ",\n";
+  #endif
+  #if ENABLED(PLANNER_FIXED_POINT_CHECK)
+    const fixed_point_error_t &fp = planner.fixed_point_error;
+    out << "  \"fixed_point_error\": { \"checks\": " << fp.checks << ", \"steps\": " << fp.steps
+        << ", \"rate\": " << fp.rate << ", \"ticks\": " << fp.ticks << " },\n";
+  #endif
+  out << "  \"block_buffer_size\": " << int(BLOCK_BUFFER_LEN) << "\n"
+      << "}\n";
+
+  return out.good();
+}
+
+#endif // LINUX_BENCHMARK
+
+#endif // __PLAT_LINUX__
@@ -0,0 +1,68 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+#include <chrono>
+#include <string>
+
+/**
+ * Planner / stepper throughput measurement for the virtual clock replay.
+ *
+ * The host time spent inside each timer ISR is sorted into a fixed log-linear
+ * histogram (within 1/32 of the true value), so memory use doesn't grow with
+ * the length of the replay. Commands run, blocks and steps executed are
+ * counted as the replay runs. On exit the
+ * results are written as JSON so a corpus run can be compared against a
+ * baseline by script (see buildroot/share/scripts/linux_benchmark.py).
+ */
+class Benchmark {
+public:
+  typedef std::chrono::steady_clock host_clock;
+
+  static void start() { started = host_clock::now(); }
+
+  // Called by the timer around every ISR
+  static host_clock::time_point isrStart() { return host_clock::now(); }
+  static void isrEnd(const uint8_t timer_id, const host_clock::time_point &begin);
+
+  // Called by GcodeSuite::process_next_command for each command run from the queue
+  static void commandDone() { commands++; }
+
+  // Write the results as JSON. Steps are counted by the simulated axes.
+  static bool report(const std::string &filename, const double virtual_seconds, const uint64_t steps);
+
+  // ISR cost histogram: exact below 64ns, then 32 buckets per power of 2 up to 2^32ns
+  static constexpr uint8_t LINEAR_NS = 64, SUB_BUCKETS = 32, LINEAR_BITS = 6, SUB_BITS = 5;
+  static constexpr uint16_t BUCKETS = LINEAR_NS + (32 - LINEAR_BITS) * SUB_BUCKETS;
+
+  struct isr_stats_t {
+    uint64_t calls, total_ns, max_ns;
+    uint64_t histogram[BUCKETS];
+  };
+
+private:
+  static host_clock::time_point started;
+  static isr_stats_t isr_cost[2]; // by timer
+  static uint64_t isr_total_ns, commands, blocks;
+  static uint8_t last_tail;
+};
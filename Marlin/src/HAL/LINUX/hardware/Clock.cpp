@@ -29,4 +29,33 @@ std::chrono::nanoseconds Clock::startup = std::chrono::high_resolution_clock::no
 uint32_t Clock::frequency = F_CPU;
 double Clock::time_multiplier = 1.0;
 
+#if ENABLED(LINUX_VIRTUAL_CLOCK)
+
+#include "Timer.h"
+
+uint64_t Clock::virtual_nanos = 0;
+
+void Clock::advance(uint64_t ns) {
+  const uint64_t target = virtual_nanos + ns;
+
+  // Interrupts are masked inside an ISR, so delays there only consume time
+  if (!Timer::inISR()) {
+    while (Timer *next = Timer::nextDue(target)) {
+      NOLESS(virtual_nanos, next->deadline());
+      next->fire();
+    }
+  }
+
+  NOLESS(virtual_nanos, target);
+}
+
+void Clock::idle() {
+  uint64_t ns = 1000000ULL;
+  Timer * const next = Timer::nextDue(virtual_nanos + ns);
+  if (next) ns = next->deadline() > virtual_nanos ? next->deadline() - virtual_nanos : 0;
+  advance(ns);
+}
+
+#endif
+
 #endif // __PLAT_LINUX__
@@ -24,6 +24,8 @@
 #include <chrono>
 #include <thread>
 
+#include "../../../inc/MarlinConfigPre.h"
+
 class Clock {
 public:
   static uint64_t ticks(uint32_t frequency = Clock::frequency) {
@@ -45,8 +47,12 @@ public:
 
   // Time Acceleration compensated
   static uint64_t nanos() {
-    auto now = std::chrono::high_resolution_clock::now().time_since_epoch();
-    return (now.count() - Clock::startup.count()) * Clock::time_multiplier;
+    #if ENABLED(LINUX_VIRTUAL_CLOCK)
+      return Clock::virtual_nanos;
+    #else
+      auto now = std::chrono::high_resolution_clock::now().time_since_epoch();
+      return (now.count() - Clock::startup.count()) * Clock::time_multiplier;
+    #endif
   }
 
   static uint64_t micros() {
@@ -61,21 +67,53 @@ public:
     return Clock::nanos() / 1000000000.0;
   }
 
-  static void delayCycles(uint64_t cycles) {
-    std::this_thread::sleep_for(std::chrono::nanoseconds( (1000000000L / frequency) * cycles) / Clock::time_multiplier );
-  }
+  #if ENABLED(LINUX_VIRTUAL_CLOCK)
 
-  static void delayMicros(uint64_t micros) {
-    std::this_thread::sleep_for(std::chrono::microseconds( micros ) / Clock::time_multiplier);
-  }
+    static void delayCycles(uint64_t cycles) {
+      Clock::advance((1000000000L / frequency) * cycles);
+    }
 
-  static void delayMillis(uint64_t millis) {
-    std::this_thread::sleep_for(std::chrono::milliseconds( millis ) / Clock::time_multiplier);
-  }
+    static void delayMicros(uint64_t micros) {
+      Clock::advance(micros * 1000);
+    }
 
-  static void delaySeconds(double secs) {
-    std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(secs * 1000) / Clock::time_multiplier);
-  }
+    static void delayMillis(uint64_t millis) {
+      Clock::advance(millis * 1000000);
+    }
+
+    static void delaySeconds(double secs) {
+      Clock::advance(secs * 1000000000.0);
+    }
+
+    /**
+     * Virtual time only moves when it is advanced explicitly. Advancing
+     * runs every timer event that falls due on the way, at its own
+     * timestamp, so results don't depend on host load or scheduling.
+     */
+    static void advance(uint64_t ns);
+
+    // Jump straight to the next timer event (at most one millisecond ahead)
+    static void idle();
+
+  #else
+
+    static void delayCycles(uint64_t cycles) {
+      std::this_thread::sleep_for(std::chrono::nanoseconds( (1000000000L / frequency) * cycles) / Clock::time_multiplier );
+    }
+
+    static void delayMicros(uint64_t micros) {
+      std::this_thread::sleep_for(std::chrono::microseconds( micros ) / Clock::time_multiplier);
+    }
+
+    static void delayMillis(uint64_t millis) {
+      std::this_thread::sleep_for(std::chrono::milliseconds( millis ) / Clock::time_multiplier);
+    }
+
+    static void delaySeconds(double secs) {
+      std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(secs * 1000) / Clock::time_multiplier);
+    }
+
+  #endif
 
   // Will reduce timer resolution increasing likelihood of overflows
   static void setTimeMultiplier(double tm) {
@@ -83,6 +121,9 @@ public:
   }
 
 private:
+  #if ENABLED(LINUX_VIRTUAL_CLOCK)
+    static uint64_t virtual_nanos;
+  #endif
   static std::chrono::nanoseconds startup;
   static uint32_t frequency;
   static double time_multiplier;
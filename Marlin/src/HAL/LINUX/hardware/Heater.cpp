@@ -34,7 +34,9 @@ Heater::Heater(pin_t heater, pin_t adc) {
   last = Clock::micros();
   heater_pin = heater;
   adc_pin = adc;
-  heat = 0.0;
+  heat = room_temp_raw;
+  // Start at room temperature rather than an open-circuit reading
+  Gpio::pin_map[analogInputToDigitalPin(adc_pin)].value = 0xFFFF - (uint16_t)heat;
 }
 
 Heater::~Heater() {
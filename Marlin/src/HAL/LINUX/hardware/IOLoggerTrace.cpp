@@ -0,0 +1,123 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef __PLAT_LINUX__
+
+#include "IOLoggerTrace.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char trace_signature[8] = { 'G', 'P', 'I', 'O', 'T', 'R', 'C', 1 };
+
+// capacity must be a power of 2
+IOLoggerTrace::IOLoggerTrace(const std::string &filename, const uint32_t capacity)
+  : ring(new Slot[capacity]), mask(capacity - 1), head(0), dropped(0),
+    tail(0), dropped_written(0), last_timestamp(0) {
+  for (uint32_t i = 0; i < capacity; i++) ring[i].sequence.store(i, std::memory_order_relaxed);
+  file.open(filename, std::ios::binary);
+  file.write(trace_signature, sizeof(trace_signature));
+}
+
+IOLoggerTrace::~IOLoggerTrace() {
+  flush();
+  file.close();
+  if (dropped) fprintf(stderr, "GPIO trace dropped %u events\n", dropped.load());
+}
+
+/**
+ * Claim a slot, fill it and publish it. The per-slot sequence number lets
+ * the timer signal handlers and the simulation thread all push safely, and
+ * a handler that interrupts a push just takes the next slot.
+ */
+void IOLoggerTrace::log(GpioEvent ev) {
+  const uint16_t value = ev.event == GpioEvent::SETM ? Gpio::getMode(ev.pin_id)
+                       : ev.event == GpioEvent::SETD ? Gpio::getDir(ev.pin_id)
+                       : Gpio::get(ev.pin_id);
+  uint32_t pos = head.load(std::memory_order_relaxed);
+  for (;;) {
+    Slot &slot = ring[pos & mask];
+    const int32_t diff = int32_t(slot.sequence.load(std::memory_order_acquire) - pos);
+    if (diff == 0) {
+      if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        slot.timestamp = ev.timestamp;
+        slot.pin = ev.pin_id;
+        slot.type = ev.event;
+        slot.value = value;
+        slot.sequence.store(pos + 1, std::memory_order_release);
+        return;
+      }
+    }
+    else if (diff < 0) {  // Full
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    else
+      pos = head.load(std::memory_order_relaxed);
+  }
+}
+
+void IOLoggerTrace::write(const uint32_t delta, const uint8_t pin, const uint8_t type, const uint16_t value) {
+  const uint8_t record[8] = {
+    uint8_t(delta), uint8_t(delta >> 8), uint8_t(delta >> 16), uint8_t(delta >> 24),
+    pin, type, uint8_t(value), uint8_t(value >> 8)
+  };
+  file.write((const char*)record, sizeof(record));
+}
+
+void IOLoggerTrace::name(const pin_type pin, const char *label) {
+  if (!Gpio::valid_pin(pin)) return;
+  const uint16_t len = strlen(label);
+  write(0, pin, NAME, len);
+  char padded[8];
+  for (uint16_t i = 0; i < len; i += 8) {
+    memset(padded, 0, sizeof(padded));
+    memcpy(padded, label + i, len - i < 8 ? len - i : 8);
+    file.write(padded, sizeof(padded));
+  }
+}
+
+void IOLoggerTrace::flush() {
+  for (;;) {
+    Slot &slot = ring[tail & mask];
+    if (slot.sequence.load(std::memory_order_acquire) != tail + 1) break;  // Nothing (more) published
+
+    // Producers can publish slightly out of order, so a step back in time needs a SYNC too
+    const uint64_t ts = slot.timestamp;
+    if (ts < last_timestamp || ts - last_timestamp > UINT32_MAX) {
+      write(uint32_t(ts), uint8_t(ts >> 48), SYNC, uint16_t(ts >> 32));
+      last_timestamp = ts;
+    }
+    write(uint32_t(ts - last_timestamp), slot.pin, slot.type, slot.value);
+    last_timestamp = ts;
+
+    slot.sequence.store(tail + mask + 1, std::memory_order_release);
+    tail++;
+  }
+
+  const uint32_t d = dropped.load(std::memory_order_relaxed);
+  if (d != dropped_written) {
+    write(d - dropped_written, 0, DROP, 0);
+    dropped_written = d;
+  }
+}
+
+#endif // __PLAT_LINUX__
@@ -0,0 +1,79 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <fstream>
+#include <string>
+#include "Gpio.h"
+
+/**
+ * GPIO event logger writing a compact binary trace.
+ *
+ * Events are pushed from the timer ISRs and the simulated peripherals into a
+ * lock-free ring, so logging never blocks or takes a lock inside a signal
+ * handler. flush() drains the ring to the file from the simulation loop.
+ * If the ring is full the event is dropped and counted, and the drop is
+ * recorded in the trace.
+ *
+ * The file starts with an 8-byte signature, followed by 8-byte records:
+ *
+ *   uint32 delta   ns since the previous event
+ *   uint8  pin
+ *   uint8  type    GpioEvent::Type, or one of the Record types below
+ *   uint16 value   pin value (or mode / direction) after the event
+ *
+ * A SYNC record carries a full 56-bit timestamp when the delta doesn't fit.
+ * A NAME record labels a pin and is followed by the name, padded to 8 bytes.
+ *
+ * Use buildroot/share/scripts/gpio_trace.py to convert a trace to CSV or to
+ * a VCD file for a waveform viewer.
+ */
+class IOLoggerTrace: public IOLogger {
+public:
+  enum Record : uint8_t { SYNC = 0xFF, NAME = 0xFE, DROP = 0xFD };
+
+  IOLoggerTrace(const std::string &filename, const uint32_t capacity=0x10000);
+  virtual ~IOLoggerTrace();
+  void log(GpioEvent ev);
+  void flush();
+  void name(const pin_type pin, const char *label);
+
+private:
+  struct Slot {
+    std::atomic<uint32_t> sequence;
+    uint64_t timestamp;
+    pin_type pin;
+    uint8_t type;
+    uint16_t value;
+  };
+
+  void write(const uint32_t delta, const uint8_t pin, const uint8_t type, const uint16_t value);
+
+  std::unique_ptr<Slot[]> ring;
+  const uint32_t mask;
+  std::atomic<uint32_t> head, dropped;
+  uint32_t tail, dropped_written;
+  uint64_t last_timestamp;
+  std::ofstream file;
+};
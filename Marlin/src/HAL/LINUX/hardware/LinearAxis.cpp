@@ -38,6 +38,7 @@ LinearAxis::LinearAxis(pin_type enable, pin_type dir, pin_type step, pin_type en
   max_position = (200*80) + min_position;
   position = rand() % ((max_position - 40) - min_position) + (min_position + 20);
   last_update = Clock::nanos();
+  steps = 0;
 
   Gpio::attachPeripheral(step_pin, this);
 
@@ -55,6 +56,7 @@ void LinearAxis::interrupt(GpioEvent ev) {
   if (ev.pin_id == step_pin && !Gpio::pin_map[enable_pin].value){
     if (ev.event == GpioEvent::RISE) {
       last_update = ev.timestamp;
+      steps++;
       position += -1 + 2 * Gpio::pin_map[dir_pin].value;
       Gpio::pin_map[min_pin].value = (position < min_position);
       //Gpio::pin_map[max_pin].value = (position > max_position);
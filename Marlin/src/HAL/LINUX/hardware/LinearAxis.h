@@ -38,6 +38,7 @@ public:
   pin_type max_pin;
 
   int32_t position;
+  uint32_t steps;
   int32_t min_position;
   int32_t max_position;
   uint64_t last_update;
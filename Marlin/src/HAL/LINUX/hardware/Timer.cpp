@@ -23,6 +23,9 @@
 #ifdef __PLAT_LINUX__
 
 #include "Timer.h"
+#if ENABLED(LINUX_BENCHMARK)
+  #include "Benchmark.h"
+#endif
 #include <stdio.h>
 
 Timer::Timer() {
@@ -38,9 +41,83 @@ Timer::Timer() {
 }
 
 Timer::~Timer() {
-  timer_delete(timerid);
+  #if DISABLED(LINUX_VIRTUAL_CLOCK)
+    timer_delete(timerid);
+  #endif
 }
 
+#if ENABLED(LINUX_VIRTUAL_CLOCK)
+
+/**
+ * Discrete-event timers: nothing runs asynchronously. The virtual clock
+ * asks for the earliest deadline and calls fire() when time reaches it,
+ * so every ISR runs at exactly its programmed compare tick.
+ */
+
+Timer* Timer::registry[4];
+uint8_t Timer::registered = 0;
+uint8_t Timer::isr_depth = 0;
+
+void Timer::init(uint32_t sig_id, uint32_t sim_freq, callback_fn* fn) {
+  id = sig_id;
+  frequency = sim_freq;
+  cbfn = fn;
+  if (registered < COUNT(registry)) registry[registered++] = this;
+}
+
+void Timer::start(uint32_t frequency) {
+  start_time = Clock::nanos();
+  setCompare(this->frequency / frequency);
+}
+
+void Timer::enable() {
+  active = true;
+}
+
+void Timer::disable() {
+  active = false;
+}
+
+void Timer::setCompare(uint32_t compare) {
+  // The count keeps running from the last match, like a reset-on-match hardware timer
+  this->compare = compare;
+  this->period = Clock::ticksToNanos(compare, frequency);
+}
+
+uint32_t Timer::getCount() {
+  return Clock::nanosToTicks(Clock::nanos() - this->start_time, frequency);
+}
+
+void Timer::fire() {
+  const uint64_t now = Clock::nanos(), due = deadline();
+  if (now > due) {
+    avg_error = (avg_error + (now - due)) / 2;
+    overruns++;
+  }
+  // Matches missed while masked collapse into a single pending interrupt
+  start_time = (now > due + period) ? now : due;
+  isr_depth++;
+  #if ENABLED(LINUX_BENCHMARK)
+    const auto begin = Benchmark::isrStart();
+    cbfn();
+    Benchmark::isrEnd(id, begin);
+  #else
+    cbfn();
+  #endif
+  isr_depth--;
+}
+
+Timer* Timer::nextDue(uint64_t limit/*=UINT64_MAX*/) {
+  Timer *next = nullptr;
+  for (uint8_t i = 0; i < registered; i++) {
+    const uint64_t due = registry[i]->deadline();
+    if (due <= limit && (!next || due < next->deadline())) next = registry[i];
+  }
+  return next;
+}
+
+#else // !LINUX_VIRTUAL_CLOCK
+
 void Timer::init(uint32_t sig_id, uint32_t sim_freq, callback_fn* fn) {
   struct sigaction sa;
   struct sigevent sev;
@@ -115,4 +192,6 @@ uint32_t Timer::getCount() {
   return Clock::nanosToTicks(Clock::nanos() - this->start_time, frequency);
 }
 
+#endif // !LINUX_VIRTUAL_CLOCK
+
 #endif // __PLAT_LINUX__
@@ -48,19 +48,37 @@ public:
   uint32_t getOverruns() {return overruns;}
   uint32_t getAvgError() {return avg_error;}
 
-  intptr_t getID() {
-    return (*(intptr_t*)timerid);
-  }
+  #if ENABLED(LINUX_VIRTUAL_CLOCK)
 
-  static void handler(int sig, siginfo_t *si, void *uc){
-    Timer* _this = (Timer*)si->si_value.sival_ptr;
-    _this->avg_error += (Clock::nanos() - _this->start_time) - _this->period; //high_resolution_clock is also limited in precision, but best we have
-    _this->avg_error /= 2; //very crude precision analysis (actually within +-500ns usually)
-    _this->start_time = Clock::nanos(); // wrap
-    _this->cbfn();
-    _this->overruns += timer_getoverrun(_this->timerid); // even at 50Khz this doesn't stay zero, again demonstrating the limitations
-                                                         // using a realtime linux kernel would help somewhat
-  }
+    // Time at which the compare match will fire, or UINT64_MAX while disabled
+    uint64_t deadline() {
+      return active ? start_time + Clock::ticksToNanos(compare, frequency) : UINT64_MAX;
+    }
+
+    // Run the ISR as if the compare matched at deadline(). The counter resets on match.
+    void fire();
+
+    // Earliest enabled timer due at or before 'limit', or nullptr
+    static Timer* nextDue(uint64_t limit=UINT64_MAX);
+    static bool inISR() { return isr_depth > 0; }
+
+  #else
+
+    intptr_t getID() {
+      return (*(intptr_t*)timerid);
+    }
+
+    static void handler(int sig, siginfo_t *si, void *uc){
+      Timer* _this = (Timer*)si->si_value.sival_ptr;
+      _this->avg_error += (Clock::nanos() - _this->start_time) - _this->period; //high_resolution_clock is also limited in precision, but best we have
+      _this->avg_error /= 2; //very crude precision analysis (actually within +-500ns usually)
+      _this->start_time = Clock::nanos(); // wrap
+      _this->cbfn();
+      _this->overruns += timer_getoverrun(_this->timerid); // even at 50Khz this doesn't stay zero, again demonstrating the limitations
+                                                           // using a realtime linux kernel would help somewhat
+    }
+
+  #endif
 
 private:
   bool active;
@@ -73,4 +91,11 @@ private:
   uint64_t period;
   uint64_t avg_error;
   uint64_t start_time;
+
+  #if ENABLED(LINUX_VIRTUAL_CLOCK)
+    uint8_t id;
+    static Timer* registry[4];
+    static uint8_t registered;
+    static uint8_t isr_depth;
+  #endif
 };
@@ -96,8 +96,13 @@ public:
 
   size_t write(char c) {
     if (!host_connected) return 0;
-    while (!transmit_buffer.free());
-    return transmit_buffer.write(c);
+    #if ENABLED(LINUX_VIRTUAL_CLOCK)
+      // No writer thread to drain the buffer, so output goes straight to stdout
+      return fputc(c, stdout) != EOF;
+    #else
+      while (!transmit_buffer.free());
+      return transmit_buffer.write(c);
+    #endif
   }
 
   operator bool() { return host_connected; }
@@ -125,11 +130,15 @@ public:
     va_end(vArgs);
     if (length > 0 && length < 256) {
       if (host_connected) {
-        for (int i = 0; i < length;) {
-          if (transmit_buffer.write(buffer[i])) {
-            ++i;
+        #if ENABLED(LINUX_VIRTUAL_CLOCK)
+          fwrite(buffer, 1, length, stdout);
+        #else
+          for (int i = 0; i < length;) {
+            if (transmit_buffer.write(buffer[i])) {
+              ++i;
+            }
           }
-        }
+        #endif
       }
     }
   }
@@ -32,10 +32,21 @@ extern void loop();
 #include <stdio.h>
 #include <stdarg.h>
 #include "../shared/Delay.h"
-#include "hardware/IOLoggerCSV.h"
+#include "hardware/IOLoggerTrace.h"
 #include "hardware/Heater.h"
 #include "hardware/LinearAxis.h"
 
+#if ENABLED(LINUX_VIRTUAL_CLOCK)
+  #include "../../gcode/queue.h"
+  #include "../../module/planner.h"
+  #if ENABLED(EEPROM_ASYNC_SAVE)
+    #include "../../module/configuration_store.h"
+  #endif
+#endif
+#if ENABLED(LINUX_BENCHMARK)
+  #include "hardware/Benchmark.h"
+#endif
+
 // simple stdout / stdin implementation for fake serial port
 void write_serial_thread() {
   for (;;) {
@@ -57,28 +68,35 @@ void read_serial_thread() {
   }
 }
 
-void simulation_loop() {
-  Heater hotend(HEATER_0_PIN, TEMP_0_PIN);
-  Heater bed(HEATER_BED_PIN, TEMP_BED_PIN);
-  LinearAxis x_axis(X_ENABLE_PIN, X_DIR_PIN, X_STEP_PIN, X_MIN_PIN, X_MAX_PIN);
-  LinearAxis y_axis(Y_ENABLE_PIN, Y_DIR_PIN, Y_STEP_PIN, Y_MIN_PIN, Y_MAX_PIN);
-  LinearAxis z_axis(Z_ENABLE_PIN, Z_DIR_PIN, Z_STEP_PIN, Z_MIN_PIN, Z_MAX_PIN);
-  LinearAxis extruder0(E0_ENABLE_PIN, E0_DIR_PIN, E0_STEP_PIN, P_NC, P_NC);
-
-  //#define GPIO_LOGGING // Full GPIO and Positional Logging
-
-  #ifdef GPIO_LOGGING
-    IOLoggerCSV logger("all_gpio_log.csv");
-    Gpio::attachLogger(&logger);
-
-    std::ofstream position_log;
-    position_log.open("axis_position_log.csv");
-
-    int32_t x,y,z;
-  #endif
-
-  for (;;) {
+//#define GPIO_LOGGING // Full GPIO and Positional Logging. Convert gpio_trace.bin with buildroot/share/scripts/gpio_trace.py
+
+class Simulation {
+public:
+  Simulation()
+    : hotend(HEATER_0_PIN, TEMP_0_PIN),
+      bed(HEATER_BED_PIN, TEMP_BED_PIN),
+      x_axis(X_ENABLE_PIN, X_DIR_PIN, X_STEP_PIN, X_MIN_PIN, X_MAX_PIN),
+      y_axis(Y_ENABLE_PIN, Y_DIR_PIN, Y_STEP_PIN, Y_MIN_PIN, Y_MAX_PIN),
+      z_axis(Z_ENABLE_PIN, Z_DIR_PIN, Z_STEP_PIN, Z_MIN_PIN, Z_MAX_PIN),
+      extruder0(E0_ENABLE_PIN, E0_DIR_PIN, E0_STEP_PIN, P_NC, P_NC)
+      #ifdef GPIO_LOGGING
+        , logger("gpio_trace.bin")
+      #endif
+  {
+    #ifdef GPIO_LOGGING
+      #define _NAME_PIN(P) logger.name(P##_PIN, #P)
+      _NAME_PIN(X_STEP); _NAME_PIN(X_DIR); _NAME_PIN(X_ENABLE); _NAME_PIN(X_MIN);
+      _NAME_PIN(Y_STEP); _NAME_PIN(Y_DIR); _NAME_PIN(Y_ENABLE); _NAME_PIN(Y_MIN);
+      _NAME_PIN(Z_STEP); _NAME_PIN(Z_DIR); _NAME_PIN(Z_ENABLE); _NAME_PIN(Z_MIN);
+      _NAME_PIN(E0_STEP); _NAME_PIN(E0_DIR); _NAME_PIN(E0_ENABLE);
+      _NAME_PIN(HEATER_0); _NAME_PIN(HEATER_BED);
+      #undef _NAME_PIN
+      Gpio::attachLogger(&logger);
+      position_log.open("axis_position_log.csv");
+    #endif
+  }
 
+  void update() {
     hotend.update();
     bed.update();
 
@@ -89,9 +107,8 @@ void simulation_loop() {
 
     #ifdef GPIO_LOGGING
       if (x_axis.position != x || y_axis.position != y || z_axis.position != z) {
-        uint64_t update = MAX3(x_axis.last_update, y_axis.last_update, z_axis.last_update);
-        position_log << update << ", " << x_axis.position << ", " << y_axis.position << ", " << z_axis.position << std::endl;
-        position_log.flush();
+        uint64_t update = _MAX(x_axis.last_update, y_axis.last_update, z_axis.last_update);
+        position_log << update << ", " << x_axis.position << ", " << y_axis.position << ", " << z_axis.position << '\n';
         x = x_axis.position;
         y = y_axis.position;
         z = z_axis.position;
@@ -99,14 +116,82 @@ void simulation_loop() {
       // flush the logger
       logger.flush();
     #endif
+  }
 
-    std::this_thread::yield();
+  uint64_t steps() {
+    return (uint64_t)x_axis.steps + y_axis.steps + z_axis.steps + extruder0.steps;
   }
-}
+
+private:
+  Heater hotend;
+  Heater bed;
+  LinearAxis x_axis;
+  LinearAxis y_axis;
+  LinearAxis z_axis;
+  LinearAxis extruder0;
+
+  #ifdef GPIO_LOGGING
+    IOLoggerTrace logger;
+    std::ofstream position_log;
+    int32_t x,y,z;
+  #endif
+};
+
+#if ENABLED(LINUX_VIRTUAL_CLOCK)
+
+  /**
+   * Deterministic replay. Marlin, the simulated peripherals and the timer
+   * ISRs all run on this one thread against the virtual clock. Input is
+   * consumed from stdin as the receive buffer drains, and the process
+   * exits once stdin is exhausted and the last move has been stepped out.
+   */
+  Simulation *simulation;
+  bool input_done = false;
+
+  void read_serial_virtual() {
+    char buffer[255] = {};
+    std::size_t len = _MIN(usb_serial.receive_buffer.free(), 254U);
+    if (input_done || len < 2) return;
+    if (fgets(buffer, len, stdin)) {
+      for (std::size_t i = 0; i < strlen(buffer); i++)
+        usb_serial.receive_buffer.write(buffer[i]);
+    }
+    else
+      input_done = true;
+  }
+
+  void HAL_idletask() {
+    Clock::idle();
+    simulation->update();
+    read_serial_virtual();
+  }
+
+  bool simulation_finished() {
+    return input_done && usb_serial.receive_buffer.empty()
+        && !queue.has_commands_queued() && !planner.has_blocks_queued()
+        #if ENABLED(EEPROM_ASYNC_SAVE)
+          && !settings.save_pending()
+        #endif
+      ;
+  }
+
+#else
+
+  void simulation_loop() {
+    Simulation simulation;
+    for (;;) {
+      simulation.update();
+      std::this_thread::yield();
+    }
+  }
+
+#endif
 
 int main() {
-  std::thread write_serial (write_serial_thread);
-  std::thread read_serial (read_serial_thread);
+  #if DISABLED(LINUX_VIRTUAL_CLOCK)
+    std::thread write_serial (write_serial_thread);
+    std::thread read_serial (read_serial_thread);
+  #endif
 
   #if NUM_SERIAL > 0
     MYSERIAL0.begin(BAUDRATE);
@@ -119,19 +204,48 @@ int main() {
 
   HAL_timer_init();
 
-  std::thread simulation (simulation_loop);
+  #if ENABLED(LINUX_VIRTUAL_CLOCK)
 
-  DELAY_US(10000);
+    simulation = new Simulation();
 
-  setup();
-  for (;;) {
-    loop();
-    std::this_thread::yield();
-  }
+    DELAY_US(10000);
 
-  simulation.join();
-  write_serial.join();
-  read_serial.join();
+    setup();
+    #if ENABLED(LINUX_BENCHMARK)
+      Benchmark::start();
+    #endif
+    while (!simulation_finished()) {
+      loop();
+      HAL_idletask();
+    }
+
+    fflush(stdout);
+    fprintf(stderr, "Simulation finished at %.6fs virtual time\n", Clock::seconds());
+
+    #if ENABLED(LINUX_BENCHMARK)
+      if (!Benchmark::report(LINUX_BENCHMARK_FILE, Clock::seconds(), simulation->steps()))
+        fprintf(stderr, "Unable to write " LINUX_BENCHMARK_FILE "\n");
+    #endif
+
+    delete simulation;
+
+  #else
+
+    std::thread simulation (simulation_loop);
+
+    DELAY_US(10000);
+
+    setup();
+    for (;;) {
+      loop();
+      std::this_thread::yield();
+    }
+
+    simulation.join();
+    write_serial.join();
+    read_serial.join();
+
+  #endif
 }
 
 #endif // __PLAT_LINUX__
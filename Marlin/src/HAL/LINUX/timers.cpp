@@ -30,6 +30,9 @@
 /**
  * Use POSIX signals to attempt to emulate Interrupts
  * This has many limitations and is not fit for the purpose
+ *
+ * With LINUX_VIRTUAL_CLOCK the timers are driven by the virtual clock instead,
+ * and the ISRs run on the main thread at their exact compare ticks.
  */
 
 HAL_STEP_TIMER_ISR();
@@ -67,6 +70,10 @@ hal_timer_t HAL_timer_get_compare(const uint8_t timer_num) {
 }
 
 hal_timer_t HAL_timer_get_count(const uint8_t timer_num) {
+  #if ENABLED(LINUX_VIRTUAL_CLOCK)
+    // Each read costs a tick so timed pulse loops in the ISRs terminate
+    Clock::advance(1000000000UL / STEPPER_TIMER_RATE);
+  #endif
   return timers[timer_num].getCount();
 }
 
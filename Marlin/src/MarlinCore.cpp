@@ -185,6 +185,12 @@
   #include "lcd/anycubic_touchscreen.h"
 #endif
 
+#if ENABLED(IDLE_TASK_SCHEDULER)
+  #include "feature/idle_scheduler.h"
+#endif
+
+#include "feature/loop_latency.h"
+
 const char NUL_STR[] PROGMEM = "",
            M112_KILL_STR[] PROGMEM = "M112 Shutdown",
            G28_STR[] PROGMEM = "G28",
@@ -553,7 +559,7 @@ inline void manage_inactivity(const bool ignore_stepper_queue=false) {
   #if ENABLED(ANYCUBIC_TOUCHSCREEN) && ENABLED(ANYCUBIC_FILAMENT_RUNOUT_SENSOR)
     AnycubicTouchscreen.FilamentRunout();
   #endif
-  if (queue.length < BUFSIZE) queue.get_available_commands();
+  if (queue.length < BUFSIZE) LOOP_TRACE(LOOP_STEP_READ, queue.get_available_commands());
 
   const millis_t ms = millis();
 
@@ -762,18 +768,26 @@ void idle(
     max7219.idle_tasks();
   #endif
 
-  #ifdef ANYCUBIC_TOUCHSCREEN
-    AnycubicTouchscreen.CommandScan();
+  #if ENABLED(STEP_TIMING_QUEUE)
+    stepper.fill_timing_queue();
+  #endif
+
+  #if DISABLED(IDLE_TASK_SCHEDULER)
+    #ifdef ANYCUBIC_TOUCHSCREEN
+      LOOP_TRACE(LOOP_STEP_TFT, AnycubicTouchscreen.CommandScan());
+    #endif
   #endif
 
   #ifdef ENDSTOP_BEEP
     EndstopBeep();
   #endif
 
-  ui.update();
+  #if DISABLED(IDLE_TASK_SCHEDULER)
+    LOOP_TRACE(LOOP_STEP_UI, ui.update());
 
-  #if ENABLED(HOST_KEEPALIVE_FEATURE)
-    gcode.host_keepalive();
+    #if ENABLED(HOST_KEEPALIVE_FEATURE)
+      gcode.host_keepalive();
+    #endif
   #endif
 
   manage_inactivity(
@@ -782,14 +796,18 @@ void idle(
     #endif
   );
 
-  thermalManager.manage_heater();
+  #if ENABLED(IDLE_TASK_SCHEDULER)
+    idle_scheduler.run();   // Touchscreen, LCD, heaters, timers, reports, SD read-ahead, EEPROM
+  #else
+    LOOP_TRACE(LOOP_STEP_HEATERS, thermalManager.manage_heater());
 
-  #if ENABLED(PRINTCOUNTER)
-    print_job_timer.tick();
-  #endif
+    #if ENABLED(PRINTCOUNTER)
+      print_job_timer.tick();
+    #endif
 
-  #if USE_BEEPER
-    buzzer.tick();
+    #if USE_BEEPER
+      buzzer.tick();
+    #endif
   #endif
 
   #if ENABLED(I2C_POSITION_ENCODERS)
@@ -807,7 +825,7 @@ void idle(
     HAL_idletask();
   #endif
 
-  #if HAS_AUTO_REPORTING
+  #if HAS_AUTO_REPORTING && DISABLED(IDLE_TASK_SCHEDULER)
     if (!gcode.autoreport_paused) {
       #if ENABLED(AUTO_REPORT_TEMPERATURES)
         thermalManager.auto_report_temperatures();
@@ -818,10 +836,24 @@ void idle(
     }
   #endif
 
+  #if ENABLED(LOOP_LATENCY_TRACE)
+    loop_latency.auto_report();
+  #endif
+
   #if ENABLED(USB_FLASH_DRIVE_SUPPORT)
     Sd2Card::idle();
   #endif
 
+  #if DISABLED(IDLE_TASK_SCHEDULER)
+    #if ENABLED(SD_READ_AHEAD)
+      LOOP_TRACE(LOOP_STEP_READ_AHEAD, card.read_ahead());
+    #endif
+
+    #if ENABLED(EEPROM_ASYNC_SAVE)
+      settings.write_pending();
+    #endif
+  #endif
+
   #if ENABLED(PRUSA_MMU2)
     mmu2.mmu_loop();
   #endif
@@ -1045,8 +1077,12 @@ void setup() {
     SERIAL_ECHO_MSG("Compiled: " __DATE__);
   #endif
 
+  #if ENABLED(BLOCK_BUFFER_AUTO_SIZE)
+    planner.allocate_block_buffer();  // Take RAM for the block buffer before anything else wants it
+  #endif
+
   SERIAL_ECHO_START();
-  SERIAL_ECHOLNPAIR(STR_FREE_MEMORY, freeMemory(), STR_PLANNER_BUFFER_BYTES, (int)sizeof(block_t) * (BLOCK_BUFFER_SIZE));
+  SERIAL_ECHOLNPAIR(STR_FREE_MEMORY, freeMemory(), STR_PLANNER_BUFFER_BYTES, (int)sizeof(block_t) * (BLOCK_BUFFER_LEN));
 
   // UI must be initialized before EEPROM
   // (because EEPROM code calls the UI).
@@ -1296,12 +1332,12 @@ void loop() {
       if (marlin_state == MF_SD_COMPLETE) finishSDPrinting();
     #endif
 
-    queue.advance();
+    LOOP_TRACE(LOOP_STEP_QUEUE, queue.advance());
 
     endstops.event_handler();
     idle();
     #ifdef ANYCUBIC_TOUCHSCREEN
-      AnycubicTouchscreen.CommandScan();
+      LOOP_TRACE(LOOP_STEP_TFT, AnycubicTouchscreen.CommandScan());
     #endif
 
   } while (ENABLED(__AVR__)); // Loop forever on slower (AVR) boards
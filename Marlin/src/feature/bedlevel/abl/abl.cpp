@@ -238,14 +238,6 @@ void print_bilinear_leveling_grid() {
   }
 #endif // ABL_BILINEAR_SUBDIVISION
 
-// Refresh after other values have been updated
-void refresh_bed_level() {
-  bilinear_grid_factor = bilinear_grid_spacing.reciprocal();
-  #if ENABLED(ABL_BILINEAR_SUBDIVISION)
-    bed_level_virt_interpolate();
-  #endif
-}
-
 #if ENABLED(ABL_BILINEAR_SUBDIVISION)
   #define ABL_BG_SPACING(A) bilinear_grid_spacing_virt.A
   #define ABL_BG_FACTOR(A)  bilinear_grid_factor_virt.A
@@ -260,6 +252,94 @@ void refresh_bed_level() {
   #define ABL_BG_GRID(X,Y)  z_values[X][Y]
 #endif
 
+#if ENABLED(ABL_BILINEAR_CELL_TABLE)
+
+  /**
+   * Bilinear coefficients for each grid cell, in microns:
+   *
+   *   z = a + b * u + c * v + d * u * v
+   *
+   * where u and v go from 0 to 1 across the cell in X and Y.
+   * Positions are converted to cells in fixed point with ABL_CELL_BITS
+   * bits of fraction, so a lookup needs no FLOOR and no cache.
+   */
+  #define ABL_CELL_BITS 12
+  #define ABL_CELL_ONE  (1L << ABL_CELL_BITS)
+
+  typedef struct { int16_t a, b, c, d; } abl_cell_t;
+
+  static abl_cell_t abl_cells[ABL_BG_POINTS_X - 1][ABL_BG_POINTS_Y - 1];
+  static xy_float_t abl_cell_factor;  // Fixed-point cells per mm
+
+  static inline int16_t abl_cell_microns(const float z) {
+    return isnan(z) ? 0 : int16_t(constrain(LROUND(z * 1000), -32767, 32767));
+  }
+
+  static void refresh_cell_table() {
+    abl_cell_factor.set(ABL_BG_FACTOR(x) * ABL_CELL_ONE, ABL_BG_FACTOR(y) * ABL_CELL_ONE);
+    for (uint8_t x = 0; x < ABL_BG_POINTS_X - 1; x++)
+      for (uint8_t y = 0; y < ABL_BG_POINTS_Y - 1; y++) {
+        const float z1 = ABL_BG_GRID(x, y),         // left-front
+                    z2 = ABL_BG_GRID(x, y + 1),     // left-back
+                    z3 = ABL_BG_GRID(x + 1, y),     // right-front
+                    z4 = ABL_BG_GRID(x + 1, y + 1); // right-back
+        abl_cell_t &cell = abl_cells[x][y];
+        cell.a = abl_cell_microns(z1);
+        cell.b = abl_cell_microns(z3 - z1);
+        cell.c = abl_cell_microns(z2 - z1);
+        cell.d = abl_cell_microns(z4 - z3 - z2 + z1);
+      }
+  }
+
+#endif // ABL_BILINEAR_CELL_TABLE
+
+// Refresh after other values have been updated
+void refresh_bed_level() {
+  bilinear_grid_factor = bilinear_grid_spacing.reciprocal();
+  #if ENABLED(ABL_BILINEAR_SUBDIVISION)
+    bed_level_virt_interpolate();
+  #endif
+  #if ENABLED(ABL_BILINEAR_CELL_TABLE)
+    refresh_cell_table();
+  #endif
+  #if ENABLED(LEVELED_SEGMENT_ADAPTIVE)
+    const xy_float_t spacing = { ABL_BG_SPACING(x), ABL_BG_SPACING(y) };
+    leveled_segment_length = adaptive_segment_length(ABL_BG_POINTS_X, ABL_BG_POINTS_Y, spacing,
+      [](const uint8_t ix, const uint8_t iy) { return ABL_BG_GRID(ix, iy); },
+      DISABLED(EXTRAPOLATE_BEYOND_GRID)
+    );
+  #endif
+}
+
+#if ENABLED(ABL_BILINEAR_CELL_TABLE)
+
+// Get the Z adjustment for non-linear bed leveling
+float bilinear_z_offset(const xy_pos_t &raw) {
+
+  // XY relative to the probed area, in fixed-point cells
+  const int32_t qx = (raw.x - bilinear_start.x) * abl_cell_factor.x,
+                qy = (raw.y - bilinear_start.y) * abl_cell_factor.y;
+
+  // The cell, constrained within bounds, and the position within it
+  const int8_t ix = constrain(qx >> ABL_CELL_BITS, 0, ABL_BG_POINTS_X - 2),
+               iy = constrain(qy >> ABL_CELL_BITS, 0, ABL_BG_POINTS_Y - 2);
+  int32_t u = qx - (int32_t(ix) << ABL_CELL_BITS),
+          v = qy - (int32_t(iy) << ABL_CELL_BITS);
+
+  #if DISABLED(EXTRAPOLATE_BEYOND_GRID)
+    // Beyond the grid maintain height at grid edges
+    LIMIT(u, 0, ABL_CELL_ONE);
+    LIMIT(v, 0, ABL_CELL_ONE);
+  #endif
+
+  const abl_cell_t &cell = abl_cells[ix][iy];
+  const int32_t left = (int32_t(cell.a) << ABL_CELL_BITS) + int32_t(cell.c) * v,  // Z at u=0, with fraction
+                slope = cell.b + ((int32_t(cell.d) * v) >> ABL_CELL_BITS);         // Z change across the cell at v
+  return (left + slope * u) * (0.001f / ABL_CELL_ONE);
+}
+
+#else
+
 // Get the Z adjustment for non-linear bed leveling
 float bilinear_z_offset(const xy_pos_t &raw) {
 
@@ -344,6 +424,8 @@ float bilinear_z_offset(const xy_pos_t &raw) {
   return offset;
 }
 
+#endif // !ABL_BILINEAR_CELL_TABLE
+
 #if IS_CARTESIAN && DISABLED(SEGMENT_LEVELED_MOVES)
 
   #define CELL_INDEX(A,V) ((V - bilinear_start.A) * ABL_BG_FACTOR(A))
@@ -221,6 +221,58 @@ void reset_bed_level() {
     SERIAL_EOL();
   }
 
+  #if ENABLED(LEVELED_SEGMENT_ADAPTIVE)
+
+    float leveled_segment_length; // = 0 (no segments needed)
+
+    /**
+     * Find the longest segment whose ends can be joined by a straight line
+     * without straying more than LEVELED_SEGMENT_TOLERANCE from the mesh.
+     *
+     * Along a line through a cell the mesh is a parabola with a second derivative
+     * of at most |z4 - z3 - z2 + z1| / (spacing.x * spacing.y), so a chord of
+     * length L is off by at most K * L^2 / 8. Where the line crosses a grid line
+     * the slope can change by up to G, adding G * L / 4. A segment no longer
+     * than a cell crosses at most one grid line in each axis.
+     *
+     * With level_edges the mesh height is held beyond the grid, so the
+     * outer grid lines also count as slope changes.
+     */
+    float adaptive_segment_length(const uint8_t sx, const uint8_t sy, const xy_float_t &spacing, element_2d_fn fn, const bool level_edges) {
+
+      // Mesh value beyond an edge: level, or carried on from the edge cell
+      #define _EDGE(Z,N) (level_edges ? (Z) : 2 * (Z) - (N))
+
+      float dmax = 0, gx = 0, gy = 0;
+      LOOP_L_N(x, sx) LOOP_L_N(y, sy) {
+        const float z = fn(x, y);
+        if (x < sx - 1 && y < sy - 1)
+          NOLESS(dmax, ABS(fn(x + 1, y + 1) - fn(x + 1, y) - fn(x, y + 1) + z));
+
+        const float xn = x < sx - 1 ? fn(x + 1, y) : _EDGE(z, fn(x - 1, y)),
+                    xp = x ? fn(x - 1, y) : _EDGE(z, xn),
+                    yn = y < sy - 1 ? fn(x, y + 1) : _EDGE(z, fn(x, y - 1)),
+                    yp = y ? fn(x, y - 1) : _EDGE(z, yn);
+        NOLESS(gx, ABS(xp - 2 * z + xn));
+        NOLESS(gy, ABS(yp - 2 * z + yn));
+      }
+
+      #undef _EDGE
+
+      const float K = dmax / (spacing.x * spacing.y),
+                  G = gx / spacing.x + gy / spacing.y,
+                  t = LEVELED_SEGMENT_TOLERANCE,
+                  denom = G * 0.25f + SQRT(sq(G * 0.25f) + K * t * 0.5f); // Root of K/8 L^2 + G/4 L = t
+
+      if (!(denom > 0)) return 0;   // A flat or planar mesh needs no segments
+
+      float len = 2 * t / denom;
+      if (G > 0) NOMORE(len, _MIN(spacing.x, spacing.y));
+      return _MAX(len, float(LEVELED_SEGMENT_LENGTH));
+    }
+
+  #endif // LEVELED_SEGMENT_ADAPTIVE
+
 #endif // AUTO_BED_LEVELING_BILINEAR || MESH_BED_LEVELING
 
 #if EITHER(MESH_BED_LEVELING, PROBE_MANUALLY)
@@ -79,6 +79,11 @@ class TemporaryBedLevelingState {
      */
     void print_2d_array(const uint8_t sx, const uint8_t sy, const uint8_t precision, element_2d_fn fn);
 
+    #if ENABLED(LEVELED_SEGMENT_ADAPTIVE)
+      extern float leveled_segment_length;
+      float adaptive_segment_length(const uint8_t sx, const uint8_t sy, const xy_float_t &spacing, element_2d_fn fn, const bool level_edges);
+    #endif
+
   #endif
 
   struct mesh_index_pair {
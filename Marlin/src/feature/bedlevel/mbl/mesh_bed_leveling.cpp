@@ -53,8 +53,24 @@
     #if ENABLED(EXTENSIBLE_UI)
       GRID_LOOP(x, y) ExtUI::onMeshUpdate(x, y, 0);
     #endif
+    #if ENABLED(LEVELED_SEGMENT_ADAPTIVE)
+      refresh_segment_length();
+    #endif
   }
 
+  #if ENABLED(LEVELED_SEGMENT_ADAPTIVE)
+
+    void mesh_bed_leveling::refresh_segment_length() {
+      // MBL carries the edge cells on linearly beyond the grid
+      const xy_float_t spacing = { MESH_X_DIST, MESH_Y_DIST };
+      leveled_segment_length = adaptive_segment_length(GRID_MAX_POINTS_X, GRID_MAX_POINTS_Y, spacing,
+        [](const uint8_t ix, const uint8_t iy) { return z_values[ix][iy]; },
+        false
+      );
+    }
+
+  #endif
+
   #if IS_CARTESIAN && DISABLED(SEGMENT_LEVELED_MOVES)
 
     /**
@@ -56,7 +56,16 @@ public:
     return false;
   }
 
-  static void set_z(const int8_t px, const int8_t py, const float &z) { z_values[px][py] = z; }
+  #if ENABLED(LEVELED_SEGMENT_ADAPTIVE)
+    static void refresh_segment_length();
+  #endif
+
+  static void set_z(const int8_t px, const int8_t py, const float &z) {
+    z_values[px][py] = z;
+    #if ENABLED(LEVELED_SEGMENT_ADAPTIVE)
+      refresh_segment_length();
+    #endif
+  }
 
   static inline void zigzag(const int8_t index, int8_t &px, int8_t &py) {
     px = index % (GRID_MAX_POINTS_X);
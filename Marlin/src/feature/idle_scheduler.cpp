@@ -0,0 +1,216 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * idle_scheduler.cpp - Cooperative scheduler for the idle() tasks
+ */
+
+#include "../inc/MarlinConfig.h"
+
+#if ENABLED(IDLE_TASK_SCHEDULER)
+
+#include "idle_scheduler.h"
+#include "loop_latency.h"
+#include "../gcode/gcode.h"
+#include "../module/planner.h"
+#include "../module/temperature.h"
+#include "../lcd/ultralcd.h"
+
+#ifdef ANYCUBIC_TOUCHSCREEN
+  #include "../lcd/anycubic_touchscreen.h"
+#endif
+#if ENABLED(PRINTCOUNTER)
+  #include "../module/printcounter.h"
+#endif
+#if USE_BEEPER
+  #include "../libs/buzzer.h"
+#endif
+#if EITHER(AUTO_REPORT_SD_STATUS, SD_READ_AHEAD)
+  #include "../sd/cardreader.h"
+#endif
+#if ENABLED(EEPROM_ASYNC_SAVE)
+  #include "../module/configuration_store.h"
+#endif
+
+IdleScheduler idle_scheduler;
+
+//
+// The tasks, in the order they run
+//
+
+#ifdef ANYCUBIC_TOUCHSCREEN
+  static void tft_run() { LOOP_TRACE(LOOP_STEP_TFT, AnycubicTouchscreen.CommandScan()); }
+#endif
+
+#if HAS_DISPLAY
+  static void lcd_run() { LOOP_TRACE(LOOP_STEP_UI, ui.update()); }
+#endif
+
+#if ENABLED(HOST_KEEPALIVE_FEATURE)
+  static void keepalive_run() { gcode.host_keepalive(); }
+#endif
+
+static void heater_run() { LOOP_TRACE(LOOP_STEP_HEATERS, thermalManager.manage_heater()); }
+
+#if ENABLED(PRINTCOUNTER)
+  static void print_timer_run() { print_job_timer.tick(); }
+  static bool print_timer_ready() { return print_job_timer.isRunning(); }
+#endif
+
+#if USE_BEEPER
+  static void buzzer_run() { buzzer.tick(); }
+#endif
+
+#if HAS_AUTO_REPORTING
+  static void auto_report_run() {
+    #if ENABLED(AUTO_REPORT_TEMPERATURES)
+      thermalManager.auto_report_temperatures();
+    #endif
+    #if ENABLED(AUTO_REPORT_SD_STATUS)
+      card.auto_report_sd_status();
+    #endif
+  }
+  static bool auto_report_ready() { return !gcode.autoreport_paused; }
+#endif
+
+#if ENABLED(SD_READ_AHEAD)
+  static void read_ahead_run() { LOOP_TRACE(LOOP_STEP_READ_AHEAD, card.read_ahead()); }
+  static bool read_ahead_ready() { return IS_SD_PRINTING(); }
+#endif
+
+#if ENABLED(EEPROM_ASYNC_SAVE)
+  static void eeprom_run() { settings.write_pending(); }
+  static bool eeprom_ready() { return settings.save_pending(); }
+#endif
+
+#define _TASK_NAME(N,S) static const char task_##N[] PROGMEM = S;
+#ifdef ANYCUBIC_TOUCHSCREEN
+  _TASK_NAME(tft, "TFT")
+#endif
+#if HAS_DISPLAY
+  _TASK_NAME(lcd, "LCD")
+#endif
+#if ENABLED(HOST_KEEPALIVE_FEATURE)
+  _TASK_NAME(keepalive, "Keepalive")
+#endif
+_TASK_NAME(heater, "Heaters")
+#if ENABLED(PRINTCOUNTER)
+  _TASK_NAME(print_timer, "Print timer")
+#endif
+#if USE_BEEPER
+  _TASK_NAME(buzzer, "Buzzer")
+#endif
+#if HAS_AUTO_REPORTING
+  _TASK_NAME(auto_report, "Auto report")
+#endif
+#if ENABLED(SD_READ_AHEAD)
+  _TASK_NAME(read_ahead, "SD read-ahead")
+#endif
+#if ENABLED(EEPROM_ASYNC_SAVE)
+  _TASK_NAME(eeprom, "EEPROM save")
+#endif
+
+static const idle_task_t idle_tasks[] PROGMEM = {
+  //  Name              Run               Ready               Period  Deferrable
+  #ifdef ANYCUBIC_TOUCHSCREEN
+    { task_tft,         tft_run,          nullptr,            5,      false },  // Keep ahead of the UART buffer
+  #endif
+  #if HAS_DISPLAY
+    { task_lcd,         lcd_run,          nullptr,            0,      false },  // Polls the encoder and buttons
+  #endif
+  #if ENABLED(HOST_KEEPALIVE_FEATURE)
+    { task_keepalive,   keepalive_run,    nullptr,            100,    true  },
+  #endif
+  { task_heater,        heater_run,       nullptr,            0,      false },  // Returns early until a new reading is in
+  #if ENABLED(PRINTCOUNTER)
+    { task_print_timer, print_timer_run,  print_timer_ready,  1000,   true  },
+  #endif
+  #if USE_BEEPER
+    { task_buzzer,      buzzer_run,       nullptr,            0,      false },
+  #endif
+  #if HAS_AUTO_REPORTING
+    { task_auto_report, auto_report_run,  auto_report_ready,  100,    true  },
+  #endif
+  #if ENABLED(SD_READ_AHEAD)
+    { task_read_ahead,  read_ahead_run,   read_ahead_ready,   0,      false },  // Feeds the parser
+  #endif
+  #if ENABLED(EEPROM_ASYNC_SAVE)
+    { task_eeprom,      eeprom_run,       eeprom_ready,       0,      true  },
+  #endif
+};
+
+#define IDLE_TASK_COUNT COUNT(idle_tasks)
+
+IdleScheduler::task_stats_t IdleScheduler::stats[IDLE_TASK_COUNT];
+uint32_t IdleScheduler::passes, IdleScheduler::deferred;
+
+void IdleScheduler::run() {
+  const millis_t now = millis();
+
+  // With only a few moves left to step, defer background work to the parser
+  const uint8_t moves = planner.movesplanned();
+  const bool starved = moves && moves < (BLOCK_BUFFER_LEN) / 4;
+
+  passes++;
+  uint32_t start = micros();  // Each task's end is the next one's start
+  LOOP_L_N(i, IDLE_TASK_COUNT) {
+    task_stats_t &s = stats[i];
+    if (PENDING(now, s.next_ms)) continue;
+
+    idle_task_t task;
+    memcpy_P(&task, &idle_tasks[i], sizeof(task));
+
+    if (starved && task.deferrable && PENDING(now, s.next_ms + (IDLE_TASK_MAX_DEFER))) { deferred++; continue; }
+    if (task.ready && !task.ready()) continue;
+
+    task.run();
+    const uint32_t end = micros(), us = end - start;
+    start = end;
+
+    s.runs++;
+    s.total_us += us;
+    NOLESS(s.max_us, _MIN(us, uint32_t(UINT16_MAX)));
+    s.next_ms = now + task.period_ms;
+  }
+}
+
+void IdleScheduler::reset() {
+  LOOP_L_N(i, IDLE_TASK_COUNT) {
+    stats[i].runs = stats[i].total_us = 0;
+    stats[i].max_us = 0;
+  }
+  passes = deferred = 0;
+}
+
+void IdleScheduler::report() {
+  SERIAL_ECHOLNPAIR("Idle passes:", passes, " deferred:", deferred);
+  LOOP_L_N(i, IDLE_TASK_COUNT) {
+    idle_task_t task;
+    memcpy_P(&task, &idle_tasks[i], sizeof(task));
+    const task_stats_t &s = stats[i];
+    serialprintPGM(task.name);
+    SERIAL_ECHOPAIR(" period:", task.period_ms, " n:", s.runs, " avg:", s.runs ? s.total_us / s.runs : 0UL, " max:", s.max_us);
+    SERIAL_ECHOLNPGM(" us");
+  }
+}
+
+#endif // IDLE_TASK_SCHEDULER
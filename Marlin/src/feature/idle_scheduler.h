@@ -0,0 +1,65 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * idle_scheduler.h - Cooperative scheduler for the idle() tasks
+ *
+ * Each task has a period and an optional readiness check, and only runs
+ * when it is due and has work to do. The run time of every task is
+ * measured for M943. While the planner buffer is running low, deferrable
+ * tasks wait up to IDLE_TASK_MAX_DEFER ms past their deadline so that
+ * command parsing and planning come first.
+ */
+
+#include "../inc/MarlinConfig.h"
+
+#if ENABLED(IDLE_TASK_SCHEDULER)
+
+typedef struct {
+  PGM_P name;
+  void (*run)();
+  bool (*ready)();      // nullptr if always ready
+  uint16_t period_ms;   // 0 to run on every pass
+  bool deferrable;      // Can wait while the planner is running low
+} idle_task_t;
+
+class IdleScheduler {
+  public:
+    static void run();
+    static void reset();
+    static void report();
+
+  private:
+    typedef struct {
+      millis_t next_ms;
+      uint32_t runs, total_us;
+      uint16_t max_us;
+    } task_stats_t;
+
+    static task_stats_t stats[];
+    static uint32_t passes, deferred;
+};
+
+extern IdleScheduler idle_scheduler;
+
+#endif // IDLE_TASK_SCHEDULER
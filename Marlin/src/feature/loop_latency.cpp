@@ -0,0 +1,102 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * loop_latency.cpp - Main loop latency tracer
+ */
+
+#include "../inc/MarlinConfig.h"
+
+#if ENABLED(LOOP_LATENCY_TRACE)
+
+#include "loop_latency.h"
+
+LoopLatency loop_latency;
+
+LoopLatency::step_stats_t LoopLatency::stats[LOOP_STEP_COUNT];
+uint8_t LoopLatency::auto_report_interval;
+millis_t LoopLatency::next_report_ms;
+
+static const char step_read[]       PROGMEM = "Command read",
+                  step_queue[]      PROGMEM = "Queue advance",
+                  step_command[]    PROGMEM = "Command",
+                  step_heaters[]    PROGMEM = "Heaters",
+                  step_ui[]         PROGMEM = "UI update"
+                  #ifdef ANYCUBIC_TOUCHSCREEN
+                    , step_tft[]        PROGMEM = "TFT scan"
+                  #endif
+                  #if ENABLED(SD_READ_AHEAD)
+                    , step_read_ahead[] PROGMEM = "SD read-ahead"
+                  #endif
+                  ;
+
+static PGM_P const step_names[LOOP_STEP_COUNT] PROGMEM = {
+  step_read, step_queue, step_command, step_heaters, step_ui
+  #ifdef ANYCUBIC_TOUCHSCREEN
+    , step_tft
+  #endif
+  #if ENABLED(SD_READ_AHEAD)
+    , step_read_ahead
+  #endif
+};
+
+void LoopLatency::record(const LoopTraceStep step, const uint32_t start_us, const uint8_t start_moves, const uint8_t start_waits) {
+  const uint32_t us = micros() - start_us;
+  const uint8_t moves = planner.movesplanned();
+  step_stats_t &s = stats[step];
+  // Seed the average and the minimum with the first call
+  if (s.calls++) {
+    s.avg_x16 += us - (s.avg_x16 >> 4);
+    NOMORE(s.min_moves, _MIN(start_moves, moves));
+  }
+  else {
+    s.avg_x16 = us << 4;
+    s.min_moves = _MIN(start_moves, moves);
+  }
+  NOLESS(s.max_us, us);
+  // Running dry in or around a deliberate wait isn't an underrun
+  const bool waited = planner.gcode_wait || planner.gcode_waits != start_waits;
+  if (start_moves && !moves && !waited && s.underruns < UINT16_MAX) s.underruns++;
+}
+
+void LoopLatency::reset() {
+  ZERO(stats);
+}
+
+void LoopLatency::report() {
+  LOOP_L_N(i, LOOP_STEP_COUNT) {
+    const step_stats_t &s = stats[i];
+    serialprintPGM((PGM_P)pgm_read_ptr(&step_names[i]));
+    SERIAL_ECHOPAIR(" n:", s.calls, " avg:", s.avg_x16 >> 4, " max:", s.max_us);
+    SERIAL_ECHOLNPAIR(" us min moves:", s.min_moves, " underruns:", s.underruns);
+  }
+}
+
+void LoopLatency::auto_report() {
+  if (auto_report_interval && ELAPSED(millis(), next_report_ms)) {
+    next_report_ms = millis() + 1000UL * auto_report_interval;
+    PORT_REDIRECT(SERIAL_BOTH);
+    report();
+  }
+}
+
+#endif // LOOP_LATENCY_TRACE
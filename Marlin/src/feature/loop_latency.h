@@ -0,0 +1,96 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * loop_latency.h - Main loop latency tracer
+ *
+ * Times each step of loop() and idle() in microseconds and keeps the
+ * longest call, a rolling average, and the lowest planner buffer fill
+ * seen around the call. A step that starts with moves queued and ends
+ * with an empty planner is counted as an underrun, pointing at the task
+ * that let the planner run dry. Waits a G-code asks for (M400, G4, M109,
+ * homing...) empty the planner on purpose, so steps that wait or run
+ * during a wait aren't counted.
+ *
+ * Steps may nest: Queue advance includes the Command step, and a command
+ * that waits runs idle() and its steps from inside both. The outer steps'
+ * times and underruns include those of the steps inside them.
+ */
+
+#include "../inc/MarlinConfig.h"
+
+#if ENABLED(LOOP_LATENCY_TRACE)
+
+#include "../module/planner.h"
+
+enum LoopTraceStep : uint8_t {
+  LOOP_STEP_READ,       // Serial and SD command reading
+  LOOP_STEP_QUEUE,      // queue.advance(), including the command
+  LOOP_STEP_COMMAND,    // gcode.process_next_command()
+  LOOP_STEP_HEATERS,
+  LOOP_STEP_UI,
+  #ifdef ANYCUBIC_TOUCHSCREEN
+    LOOP_STEP_TFT,
+  #endif
+  #if ENABLED(SD_READ_AHEAD)
+    LOOP_STEP_READ_AHEAD,
+  #endif
+  LOOP_STEP_COUNT
+};
+
+class LoopLatency {
+  public:
+    typedef struct {
+      uint32_t calls, max_us, avg_x16; // Rolling average over about 16 calls
+      uint8_t min_moves;
+      uint16_t underruns;
+    } step_stats_t;
+
+    static step_stats_t stats[LOOP_STEP_COUNT];
+
+    FORCE_INLINE static uint8_t start_moves() { return planner.movesplanned(); }
+
+    static void record(const LoopTraceStep step, const uint32_t start_us, const uint8_t start_moves, const uint8_t start_waits);
+
+    static void reset();
+    static void report();
+
+    static uint8_t auto_report_interval;
+    static millis_t next_report_ms;
+    static void auto_report();
+    static inline void set_auto_report_interval(uint8_t v) {
+      NOMORE(v, 60);
+      auto_report_interval = v;
+      next_report_ms = millis() + 1000UL * v;
+    }
+};
+
+extern LoopLatency loop_latency;
+
+#define LOOP_TRACE(STEP, CODE) do{ const uint8_t _trace_moves = LoopLatency::start_moves(), _trace_waits = planner.gcode_waits; const uint32_t _trace_us = micros(); CODE; LoopLatency::record(STEP, _trace_us, _trace_moves, _trace_waits); }while(0)
+
+#else
+
+#define LOOP_TRACE(STEP, CODE) CODE
+
+#endif // LOOP_LATENCY_TRACE
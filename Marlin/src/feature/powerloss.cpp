@@ -39,6 +39,9 @@ const char PrintJobRecovery::filename[5] = "/PLR";
 uint8_t PrintJobRecovery::queue_index_r;
 uint32_t PrintJobRecovery::cmd_sdpos, // = 0
          PrintJobRecovery::sdpos[BUFSIZE];
+#if ENABLED(POWER_LOSS_JOURNAL)
+  uint32_t PrintJobRecovery::journal_block; // = 0
+#endif
 
 #include "../sd/cardreader.h"
 #include "../lcd/ultralcd.h"
@@ -54,6 +57,11 @@ uint32_t PrintJobRecovery::cmd_sdpos, // = 0
   #include "fwretract.h"
 #endif
 
+#if ENABLED(POWER_LOSS_JOURNAL)
+  #include "../libs/crc16.h"
+  static_assert(sizeof(job_recovery_info_t) <= 512, "job_recovery_info_t must fit in one SD block for POWER_LOSS_JOURNAL.");
+#endif
+
 #define DEBUG_OUT ENABLED(DEBUG_POWER_LOSS_RECOVERY)
 #include "../core/debug_out.h"
 
@@ -113,6 +121,9 @@ void PrintJobRecovery::check() {
  */
 void PrintJobRecovery::purge() {
   init();
+  #if ENABLED(POWER_LOSS_JOURNAL)
+    journal_block = 0;
+  #endif
   card.removeJobRecoveryFile();
 }
 
@@ -122,18 +133,68 @@ void PrintJobRecovery::purge() {
 void PrintJobRecovery::load() {
   if (exists()) {
     open(true);
-    (void)file.read(&info, sizeof(info));
+    #if ENABLED(POWER_LOSS_JOURNAL)
+      // Use the newest intact record
+      uint32_t newest_seq = 0;
+      uint8_t newest = 0;
+      for (uint8_t i = 0; i < POWER_LOSS_JOURNAL_BLOCKS; i++) {
+        if (!file.seekSet(uint32_t(i) * 512) || file.read(&info, sizeof(info)) != int16_t(sizeof(info))) break;
+        if (info.journal_seq > newest_seq && info.journal_crc == journal_crc()) {
+          newest_seq = info.journal_seq;
+          newest = i;
+        }
+      }
+      if (newest_seq && file.seekSet(uint32_t(newest) * 512))
+        (void)file.read(&info, sizeof(info));
+      else
+        init();
+    #else
+      (void)file.read(&info, sizeof(info));
+    #endif
     close();
   }
   debug(PSTR("Load"));
 }
 
+#if ENABLED(POWER_LOSS_JOURNAL)
+
+  /**
+   * Open the journal and continue numbering after its newest record
+   */
+  void PrintJobRecovery::open_journal() {
+    journal_block = card.openJobRecoveryJournal();
+    if (!journal_block) return;
+    uint32_t seq = 0;
+    for (uint8_t i = 0; i < POWER_LOSS_JOURNAL_BLOCKS; i++) {
+      uint32_t s;
+      if (file.seekSet(uint32_t(i) * 512 + offsetof(job_recovery_info_t, journal_seq))
+        && file.read(&s, sizeof(s)) == int16_t(sizeof(s))
+      ) NOLESS(seq, s);
+    }
+    close();
+    info.journal_seq = seq;
+  }
+
+  uint16_t PrintJobRecovery::journal_crc() {
+    const uint16_t saved = info.journal_crc;
+    info.journal_crc = 0;
+    uint16_t crc = 0;
+    crc16(&crc, &info, sizeof(info));
+    info.journal_crc = saved;
+    return crc;
+  }
+
+#endif
+
 /**
  * Set info fields that won't change
  */
 void PrintJobRecovery::prepare() {
   card.getAbsFilename(info.sd_filename);  // SD filename
   cmd_sdpos = 0;
+  #if ENABLED(POWER_LOSS_JOURNAL)
+    if (!journal_block) open_journal();   // Any FAT work is done at print start, not mid-print
+  #endif
 }
 
 /**
@@ -273,11 +334,25 @@ void PrintJobRecovery::write() {
 
   debug(PSTR("Write"));
 
-  open(false);
-  file.seekSet(0);
-  const int16_t ret = file.write(&info, sizeof(info));
-  if (ret == -1) DEBUG_ECHOLNPGM("Power-loss file write failed.");
-  if (!file.close()) DEBUG_ECHOLNPGM("Power-loss file close failed.");
+  #if ENABLED(POWER_LOSS_JOURNAL)
+
+    // Each record goes to the next block of the journal in one raw write
+    if (!journal_block) open_journal();
+    if (!journal_block) return;
+    info.journal_seq++;
+    info.journal_crc = journal_crc();
+    if (!card.writeJobRecoveryBlock(journal_block + info.journal_seq % (POWER_LOSS_JOURNAL_BLOCKS), &info, sizeof(info)))
+      DEBUG_ECHOLNPGM("Power-loss journal write failed.");
+
+  #else
+
+    open(false);
+    file.seekSet(0);
+    const int16_t ret = file.write(&info, sizeof(info));
+    if (ret == -1) DEBUG_ECHOLNPGM("Power-loss file write failed.");
+    if (!file.close()) DEBUG_ECHOLNPGM("Power-loss file close failed.");
+
+  #endif
 }
 
 /**
@@ -43,6 +43,11 @@
 typedef struct {
   uint8_t valid_head;
 
+  #if ENABLED(POWER_LOSS_JOURNAL)
+    uint32_t journal_seq;   // Record number, 0 in an empty block
+    uint16_t journal_crc;   // CRC16 of the record with this field zeroed
+  #endif
+
   // Machine state
   xyze_pos_t current_position;
 
@@ -148,6 +153,10 @@ class PrintJobRecovery {
     static void enable(const bool onoff);
     static void changed();
 
+  #if ENABLED(POWER_LOSS_JOURNAL)
+    static uint32_t journal_block;     //!< First block of the journal on the card, 0 if not open
+  #endif
+
     static inline bool exists() { return card.jobRecoverFileExists(); }
     static inline void open(const bool read) { card.openJobRecoveryFile(read); }
     static inline void close() { file.close(); }
@@ -179,6 +188,11 @@ class PrintJobRecovery {
   private:
     static void write();
 
+  #if ENABLED(POWER_LOSS_JOURNAL)
+    static void open_journal();
+    static uint16_t journal_crc();
+  #endif
+
   #if ENABLED(BACKUP_POWER_SUPPLY)
     static void raise_z();
   #endif
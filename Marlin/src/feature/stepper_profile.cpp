@@ -0,0 +1,115 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * stepper_profile.cpp - Stepper ISR load profiler
+ */
+
+#include "../inc/MarlinConfig.h"
+
+#if ENABLED(STEPPER_ISR_PROFILE)
+
+#include "stepper_profile.h"
+#include "../module/stepper.h"
+
+StepperProfile stepper_profile;
+
+uint32_t StepperProfile::histogram[ISR_PHASE_COUNT][STEPPER_PROFILE_BUCKETS];
+hal_timer_t StepperProfile::longest[ISR_PHASE_COUNT];
+uint32_t StepperProfile::multisteps[STEPPER_PROFILE_MULTISTEPS];
+uint32_t StepperProfile::max_loops_hit; // = 0
+#if ENABLED(STEP_TIMER_CHECK)
+  uint32_t StepperProfile::timer_checks, StepperProfile::timer_error;
+#endif
+#if ENABLED(STEP_TIMING_QUEUE)
+  uint32_t StepperProfile::timing_queued, StepperProfile::timing_inline;
+#endif
+
+#define CYCLES_PER_TICK ((F_CPU) / (STEPPER_TIMER_RATE))
+
+void StepperProfile::reset() {
+  const bool was_enabled = stepper.suspend();
+  ZERO(histogram);
+  ZERO(longest);
+  ZERO(multisteps);
+  max_loops_hit = 0;
+  #if ENABLED(STEP_TIMER_CHECK)
+    timer_checks = timer_error = 0;
+  #endif
+  #if ENABLED(STEP_TIMING_QUEUE)
+    timing_queued = timing_inline = 0;
+  #endif
+  if (was_enabled) stepper.wake_up();
+}
+
+void StepperProfile::report() {
+  static const char phase_pulse[]    PROGMEM = "Pulse",
+                    phase_advance[]  PROGMEM = "Advance",
+                    phase_babystep[] PROGMEM = "Babystep",
+                    phase_block[]    PROGMEM = "Block",
+                    phase_total[]    PROGMEM = "ISR";
+  static PGM_P const phase_name[ISR_PHASE_COUNT] PROGMEM = {
+    phase_pulse, phase_advance, phase_babystep, phase_block, phase_total
+  };
+
+  SERIAL_ECHOLNPAIR("Stepper ISR profile (cycles, ", CYCLES_PER_TICK, " per tick)");
+
+  LOOP_L_N(p, ISR_PHASE_COUNT) {
+    // Copy one row at a time so the report doesn't hold off stepping for long
+    uint32_t row[STEPPER_PROFILE_BUCKETS];
+    const bool was_enabled = stepper.suspend();
+    COPY(row, histogram[p]);
+    const hal_timer_t max_ticks = longest[p];
+    if (was_enabled) stepper.wake_up();
+
+    uint32_t calls = 0;
+    LOOP_L_N(b, STEPPER_PROFILE_BUCKETS) calls += row[b];
+    if (!calls) continue;
+
+    serialprintPGM((PGM_P)pgm_read_ptr(&phase_name[p]));
+    SERIAL_ECHOPAIR(" n:", calls, " max:", uint32_t(max_ticks) * CYCLES_PER_TICK);
+    LOOP_L_N(b, STEPPER_PROFILE_BUCKETS) if (row[b]) {
+      // Label each bucket with its lower bound in cycles
+      SERIAL_CHAR(' ');
+      if (b == STEPPER_PROFILE_BUCKETS - 1) SERIAL_CHAR('>');
+      SERIAL_ECHO(b ? (1UL << (b - 1)) * CYCLES_PER_TICK : 0UL);
+      SERIAL_CHAR(':');
+      SERIAL_ECHO(row[b]);
+    }
+    SERIAL_EOL();
+  }
+
+  SERIAL_ECHOPGM("Multistep");
+  LOOP_L_N(m, STEPPER_PROFILE_MULTISTEPS) if (multisteps[m]) SERIAL_ECHOPAIR(" ", 1UL << m, "x:", multisteps[m]);
+  SERIAL_EOL();
+
+  SERIAL_ECHOLNPAIR("Loop guard hits:", max_loops_hit);
+  SERIAL_ECHOLNPAIR("Estimated cycles base:", ISR_BASE_CYCLES + ISR_S_CURVE_CYCLES, " per step:", ISR_LOOP_CYCLES);
+  #if ENABLED(STEP_TIMER_CHECK)
+    SERIAL_ECHOLNPAIR("Step timer checks:", timer_checks, " max error ticks:", timer_error);
+  #endif
+  #if ENABLED(STEP_TIMING_QUEUE)
+    SERIAL_ECHOLNPAIR("Step timing queued:", timing_queued, " inline:", timing_inline);
+  #endif
+}
+
+#endif // STEPPER_ISR_PROFILE
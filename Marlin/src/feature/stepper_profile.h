@@ -0,0 +1,99 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * stepper_profile.h - Stepper ISR load profiler
+ *
+ * Times each phase of Stepper::isr() with the stepper timer and sorts the
+ * results into log2 histograms. Phases run with interrupts enabled, so a
+ * phase that was preempted by serial or temperature ISRs lands in a higher
+ * bucket. The whole-ISR histogram includes the loop overhead.
+ */
+
+#include "../inc/MarlinConfig.h"
+
+#if ENABLED(STEPPER_ISR_PROFILE)
+
+enum StepperISRPhase : uint8_t {
+  ISR_PHASE_PULSE,
+  ISR_PHASE_ADVANCE,
+  ISR_PHASE_BABYSTEP,
+  ISR_PHASE_BLOCK,
+  ISR_PHASE_TOTAL,
+  ISR_PHASE_COUNT
+};
+
+// Bucket 0 is zero ticks, bucket N is [2^(N-1), 2^N) ticks, the last bucket is open-ended
+#define STEPPER_PROFILE_BUCKETS 12
+
+// Pulse phases run at each steps-per-ISR multiplier, 1x through 128x
+#define STEPPER_PROFILE_MULTISTEPS 8
+
+class StepperProfile {
+  public:
+    static uint32_t histogram[ISR_PHASE_COUNT][STEPPER_PROFILE_BUCKETS];
+    static hal_timer_t longest[ISR_PHASE_COUNT];
+    static uint32_t multisteps[STEPPER_PROFILE_MULTISTEPS];
+    static uint32_t max_loops_hit;  // Times the ISR loop guard gave up on pulse timing
+
+    #if ENABLED(STEP_TIMER_CHECK)
+      static uint32_t timer_checks, timer_error; // Intervals checked against a division, largest difference in ticks
+      FORCE_INLINE static void check_timer(const uint32_t timer, const uint32_t exact) {
+        timer_checks++;
+        NOLESS(timer_error, timer > exact ? timer - exact : exact - timer);
+      }
+    #endif
+
+    #if ENABLED(STEP_TIMING_QUEUE)
+      static uint32_t timing_queued, timing_inline; // Block phases taken from the timing queue, worked out in the ISR
+    #endif
+
+    FORCE_INLINE static hal_timer_t now() { return HAL_timer_get_count(STEP_TIMER_NUM); }
+
+    FORCE_INLINE static void record(const StepperISRPhase phase, const hal_timer_t start) {
+      const hal_timer_t ticks = now() - start;
+      uint8_t b = 0;
+      for (hal_timer_t t = ticks; t && b < STEPPER_PROFILE_BUCKETS - 1; t >>= 1) b++;
+      histogram[phase][b]++;
+      NOLESS(longest[phase], ticks);
+    }
+
+    FORCE_INLINE static void multistep(uint8_t steps_per_isr) {
+      uint8_t m = 0;
+      while (steps_per_isr >>= 1) m++;
+      multisteps[_MIN(m, STEPPER_PROFILE_MULTISTEPS - 1)]++;
+    }
+
+    static void reset();
+    static void report();
+};
+
+extern StepperProfile stepper_profile;
+
+#define ISR_PROFILE(PHASE, CODE) do{ const hal_timer_t _phase_start = StepperProfile::now(); CODE; StepperProfile::record(PHASE, _phase_start); }while(0)
+
+#else
+
+#define ISR_PROFILE(PHASE, CODE) CODE
+
+#endif // STEPPER_ISR_PROFILE
@@ -77,6 +77,11 @@ void GcodeSuite::M420() {
           ExtUI::onMeshUpdate(x, y, Z_VALUES(x, y));
         #endif
       }
+      #if ENABLED(AUTO_BED_LEVELING_BILINEAR)
+        refresh_bed_level();
+      #elif ENABLED(LEVELED_SEGMENT_ADAPTIVE)
+        mbl.refresh_segment_length();
+      #endif
       SERIAL_ECHOPGM("Simulated " STRINGIFY(GRID_MAX_POINTS_X) "x" STRINGIFY(GRID_MAX_POINTS_Y) " mesh ");
       SERIAL_ECHOPAIR(" (", x_min);
       SERIAL_CHAR(','); SERIAL_ECHO(y_min);
@@ -186,8 +191,10 @@ void GcodeSuite::M420() {
                   ExtUI::onMeshUpdate(x, y, Z_VALUES(x, y));
                 #endif
               }
-            #if ENABLED(ABL_BILINEAR_SUBDIVISION)
-              bed_level_virt_interpolate();
+            #if ENABLED(AUTO_BED_LEVELING_BILINEAR) && ANY(ABL_BILINEAR_SUBDIVISION, ABL_BILINEAR_CELL_TABLE, LEVELED_SEGMENT_ADAPTIVE)
+              refresh_bed_level();
+            #elif BOTH(MESH_BED_LEVELING, LEVELED_SEGMENT_ADAPTIVE)
+              mbl.refresh_segment_length();
             #endif
           }
 
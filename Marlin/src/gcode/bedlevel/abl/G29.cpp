@@ -322,8 +322,8 @@ G29_TYPE GcodeSuite::G29() {
         if (WITHIN(i, 0, GRID_MAX_POINTS_X - 1) && WITHIN(j, 0, GRID_MAX_POINTS_Y)) {
           set_bed_leveling_enabled(false);
           z_values[i][j] = rz;
-          #if ENABLED(ABL_BILINEAR_SUBDIVISION)
-            bed_level_virt_interpolate();
+          #if EITHER(ABL_BILINEAR_SUBDIVISION, ABL_BILINEAR_CELL_TABLE)
+            refresh_bed_level();
           #endif
           #if ENABLED(EXTENSIBLE_UI)
             ExtUI::onMeshUpdate(i, j, rz);
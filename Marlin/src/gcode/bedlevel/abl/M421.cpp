@@ -55,8 +55,8 @@ void GcodeSuite::M421() {
     SERIAL_ERROR_MSG(STR_ERR_MESH_XY);
   else {
     z_values[ix][iy] = parser.value_linear_units() + (hasQ ? z_values[ix][iy] : 0);
-    #if ENABLED(ABL_BILINEAR_SUBDIVISION)
-      bed_level_virt_interpolate();
+    #if EITHER(ABL_BILINEAR_SUBDIVISION, ABL_BILINEAR_CELL_TABLE)
+      refresh_bed_level();
     #endif
     #if ENABLED(EXTENSIBLE_UI)
       ExtUI::onMeshUpdate(ix, iy, z_values[ix][iy]);
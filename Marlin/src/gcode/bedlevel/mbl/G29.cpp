@@ -177,7 +177,7 @@ void GcodeSuite::G29() {
         return echo_not_entered('J');
 
       if (parser.seenval('Z')) {
-        mbl.z_values[ix][iy] = parser.value_linear_units();
+        mbl.set_z(ix, iy, parser.value_linear_units());
         #if ENABLED(EXTENSIBLE_UI)
           ExtUI::onMeshUpdate(ix, iy, mbl.z_values[ix][iy]);
         #endif
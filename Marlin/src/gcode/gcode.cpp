@@ -55,6 +55,10 @@ GcodeSuite gcode;
 
 #include "../MarlinCore.h" // for idle()
 
+#if ENABLED(LINUX_BENCHMARK)
+  #include "../HAL/LINUX/hardware/Benchmark.h"
+#endif
+
 millis_t GcodeSuite::previous_move_ms;
 
 // Relative motion mode for each logical axis
@@ -841,6 +845,26 @@ void GcodeSuite::process_parsed_command(const bool no_ok/*=false*/) {
         case 869: M869(); break;                                  // M869: Report axis error
       #endif
 
+      #if ENABLED(STEPPER_ISR_PROFILE)
+        case 940: M940(); break;                                  // M940: Report the stepper ISR load profile
+      #endif
+
+      #if HAS_PLANNER_REPORT
+        case 941: M941(); break;                                  // M941: Report planner statistics
+      #endif
+
+      #if ENABLED(ANYCUBIC_TFT_TX_QUEUE)
+        case 942: M942(); break;                                  // M942: Report TFT output queue stalls
+      #endif
+
+      #if ENABLED(IDLE_TASK_SCHEDULER)
+        case 943: M943(); break;                                  // M943: Report idle task run times
+      #endif
+
+      #if ENABLED(LOOP_LATENCY_TRACE)
+        case 944: M944(); break;                                  // M944: Report main loop latencies
+      #endif
+
       #if ENABLED(MAGNETIC_PARKING_EXTRUDER)
         case 951: M951(); break;                                  // M951: Set Magnetic Parking Extruder parameters
       #endif
@@ -906,9 +930,19 @@ void GcodeSuite::process_next_command() {
     #endif
   }
 
-  // Parse the next command in the queue
-  parser.parse(current_command);
+  // Parse the next command in the queue, unless it was tokenized when queued
+  #if ENABLED(GCODE_QUEUE_TOKENS)
+    const uint8_t tokens = queue.token_offset[queue.index_r];
+    if (tokens)
+      parser.parse_tokens(current_command, tokens);
+    else
+  #endif
+      parser.parse(current_command);
   process_parsed_command();
+
+  #if ENABLED(LINUX_BENCHMARK)
+    Benchmark::commandDone();
+  #endif
 }
 
 /**
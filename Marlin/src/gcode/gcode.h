@@ -262,6 +262,11 @@
  * M916 - L6470 tuning: Increase KVAL_HOLD until thermal warning. (Requires at least one _DRIVER_TYPE L6470)
  * M917 - L6470 tuning: Find minimum current thresholds. (Requires at least one _DRIVER_TYPE L6470)
  * M918 - L6470 tuning: Increase speed until max or error. (Requires at least one _DRIVER_TYPE L6470)
+ * M940 - Report the stepper ISR load profile. R to reset it. (Requires STEPPER_ISR_PROFILE)
+ * M941 - Report planner statistics. R to reset them. (Requires PLANNER_LOOKAHEAD_STATS, PLANNER_FIXED_POINT_CHECK or PLANNER_UNDERRUN_STATS)
+ * M942 - Report TFT output queue stalls. R to reset them. (Requires ANYCUBIC_TFT_TX_QUEUE)
+ * M943 - Report idle task run times. R to reset them. (Requires IDLE_TASK_SCHEDULER)
+ * M944 - Report main loop latencies. R to reset, S<seconds> to auto-report. (Requires LOOP_LATENCY_TRACE)
  * M951 - Set Magnetic Parking Extruder parameters. (Requires MAGNETIC_PARKING_EXTRUDER)
  * M7219 - Control Max7219 Matrix LEDs. (Requires MAX7219_GCODE)
  *
@@ -953,6 +958,26 @@ private:
     static void M928();
   #endif
 
+  #if ENABLED(STEPPER_ISR_PROFILE)
+    static void M940();
+  #endif
+
+  #if HAS_PLANNER_REPORT
+    static void M941();
+  #endif
+
+  #if ENABLED(ANYCUBIC_TFT_TX_QUEUE)
+    static void M942();
+  #endif
+
+  #if ENABLED(IDLE_TASK_SCHEDULER)
+    static void M943();
+  #endif
+
+  #if ENABLED(LOOP_LATENCY_TRACE)
+    static void M944();
+  #endif
+
   #if ENABLED(MAGNETIC_PARKING_EXTRUDER)
     static void M951();
   #endif
@@ -66,6 +66,9 @@ int GCodeParser::codenum;
   // Optimized Parameters
   uint32_t GCodeParser::codebits;  // found bits
   uint8_t GCodeParser::param[26];  // parameter offsets from command_ptr
+  #if ENABLED(GCODE_QUEUE_TOKENS)
+    char *GCodeParser::tokens;     // pre-parsed command, if any
+  #endif
 #else
   char *GCodeParser::command_args; // start of parameters
 #endif
@@ -89,6 +92,9 @@ void GCodeParser::reset() {
   #if ENABLED(FASTER_GCODE_PARSER)
     codebits = 0;                       // No codes yet
     //ZERO(param);                      // No parameters (should be safe to comment out this line)
+    #if ENABLED(GCODE_QUEUE_TOKENS)
+      tokens = nullptr;                 // Not tokenized
+    #endif
   #endif
 }
 
@@ -353,6 +359,131 @@ void GCodeParser::parse(char *p) {
   }
 }
 
+#if ENABLED(GCODE_QUEUE_TOKENS)
+
+  #if ENABLED(ARC_SUPPORT)
+    #define TOKEN_GTOP 3
+  #else
+    #define TOKEN_GTOP 1
+  #endif
+
+  /**
+   * Tokenize a queued move whose parameters are all plain numbers so it
+   * won't need parse() when it runs. The tokens are stored after the nul:
+   *
+   *   [command offset] [code number] [count] ( [letter] [float] ) * count
+   *
+   * Values are converted with one exact division, so they match strtof.
+   * Return the offset of the tokens, or 0 to leave the command as text.
+   */
+  uint8_t GCodeParser::tokenize(char * const cmd) {
+    char *p = cmd;
+
+    // Skip spaces and N[-0-9]* as parse() does
+    while (*p == ' ') ++p;
+    if (*p == 'N' && NUMERIC_SIGNED(p[1])) {
+      p += 2;
+      while (NUMERIC(*p)) ++p;
+      while (*p == ' ') ++p;
+    }
+    const uint8_t command_offset = p - cmd;
+
+    // Only G0 and G1, or G2 and G3 with ARC_SUPPORT, and no sub-code
+    if (*p++ != 'G') return 0;
+    while (*p == ' ') ++p;
+    const uint8_t code = *p++ - '0';
+    if (code > TOKEN_GTOP || NUMERIC(*p) || *p == '.') return 0;
+
+    const uint8_t at = (p - cmd) + strlen(p) + 1;
+    uint8_t * const rec = (uint8_t*)cmd + at, len = 3, count = 0;
+
+    for (;;) {
+      while (*p == ' ') ++p;
+      const char letter = *p;
+      if (!letter || letter == '*') break;
+      if (!WITHIN(letter, 'A', 'Z') || at + len + 1 + sizeof(float) > MAX_CMD_SIZE) return 0;
+      ++p;
+      while (*p == ' ') ++p;                    // Spaces between parameter & value
+
+      // [-+]?[0-9]*.?[0-9]* with up to 24 bits of mantissa
+      const bool neg = *p == '-';
+      if (neg || *p == '+') ++p;
+      uint32_t mant = 0;
+      uint8_t digits = 0, decimals = 0;
+      bool point = false;
+      for (;; ++p) {
+        if (NUMERIC(*p)) {
+          mant = mant * 10 + (*p - '0');
+          if (mant > 0xFFFFFFUL) return 0;
+          ++digits;
+          if (point) ++decimals;
+        }
+        else if (*p == '.' && !point)
+          point = true;
+        else
+          break;
+      }
+      if (!digits || decimals > 10) return 0;   // No value, or not exact below
+      if (*p && *p != ' ' && *p != '*' && !WITHIN(*p, 'A', 'Z')) return 0;
+
+      float v = mant;
+      if (decimals) {
+        float d = 10;                           // Powers of 10 up to 1e10 are exact
+        while (--decimals) d *= 10;
+        v /= d;
+      }
+      if (neg) v = -v;
+
+      rec[len++] = letter;
+      memcpy(&rec[len], &v, sizeof(v));
+      len += sizeof(v);
+      ++count;
+    }
+
+    rec[0] = command_offset;
+    rec[1] = code;
+    rec[2] = count;
+    return at;
+  }
+
+  uint8_t GCodeParser::tokenize_move(char * const cmd, const uint8_t code, const char * const letters, const float * const values, const uint8_t count) {
+    cmd[0] = 'G';
+    cmd[1] = '0' + code;
+    cmd[2] = '\0';
+    uint8_t * const rec = (uint8_t*)cmd + 3, len = 3;
+    rec[0] = 0;
+    rec[1] = code;
+    rec[2] = count;
+    for (uint8_t i = 0; i < count; ++i) {
+      rec[len++] = letters[i];
+      memcpy(&rec[len], &values[i], sizeof(float));
+      len += sizeof(float);
+    }
+    return 3;
+  }
+
+  void GCodeParser::parse_tokens(char * const cmd, const uint8_t at) {
+    reset();
+    tokens = cmd + at;
+    const uint8_t * const rec = (uint8_t*)tokens;
+    command_ptr = cmd + rec[0];
+    command_letter = 'G';
+    codenum = rec[1];
+    #if ENABLED(GCODE_MOTION_MODES)
+      motion_mode_codenum = codenum;
+      #if ENABLED(USE_GCODE_SUBCODES)
+        motion_mode_subcode = 0;
+      #endif
+    #endif
+    for (uint8_t i = 0, o = 3; i < rec[2]; ++i, o += 1 + sizeof(float)) {
+      const uint8_t ind = LETTER_BIT(rec[o]);
+      SBI32(codebits, ind);
+      param[ind] = o + 1;                       // Offset of the value from tokens
+    }
+  }
+
+#endif // GCODE_QUEUE_TOKENS
+
 #if ENABLED(CNC_COORDINATE_SYSTEMS)
 
   // Parse the next parameter as a new command
@@ -62,6 +62,9 @@ private:
   #if ENABLED(FASTER_GCODE_PARSER)
     static uint32_t codebits;       // Parameters pre-scanned
     static uint8_t param[26];       // For A-Z, offsets into command args
+    #if ENABLED(GCODE_QUEUE_TOKENS)
+      static char *tokens;          // Tokens of a pre-parsed command. Param offsets are relative to this.
+    #endif
   #else
     static char *command_args;      // Args start here, for slow scan
   #endif
@@ -142,6 +145,9 @@ public:
       if (ind >= COUNT(param)) return false; // Only A-Z
       const bool b = TEST32(codebits, ind);
       if (b) {
+        #if ENABLED(GCODE_QUEUE_TOKENS)
+          if (tokens) { value_ptr = tokens + param[ind]; return b; }
+        #endif
         char * const ptr = command_ptr + param[ind];
         value_ptr = param[ind] && valid_float(ptr) ? ptr : nullptr;
       }
@@ -230,6 +236,17 @@ public:
   // This uses 54 bytes of SRAM to speed up seen/value
   static void parse(char * p);
 
+  #if ENABLED(GCODE_QUEUE_TOKENS)
+    // Store the parameters of a queued move after its text
+    static uint8_t tokenize(char * const cmd);
+    // Populate all fields from a tokenized command
+    static void parse_tokens(char * const cmd, const uint8_t at);
+    // Store a move that was read as binary values. Its text is just the command.
+    static uint8_t tokenize_move(char * const cmd, const uint8_t code, const char * const letters, const float * const values, const uint8_t count);
+    // A tokenized value. Tokenized commands have no string values.
+    static inline float token_value() { float f; memcpy(&f, value_ptr, sizeof(f)); return f; }
+  #endif
+
   #if ENABLED(CNC_COORDINATE_SYSTEMS)
     // Parse the next parameter as a new command
     static bool chain();
@@ -247,6 +264,9 @@ public:
   // Float removes 'E' to prevent scientific notation interpretation
   static inline float value_float() {
     if (value_ptr) {
+      #if ENABLED(GCODE_QUEUE_TOKENS)
+        if (tokens) return token_value();
+      #endif
       char *e = value_ptr;
       for (;;) {
         const char c = *e;
@@ -265,8 +285,13 @@ public:
   }
 
   // Code value as a long or ulong
-  static inline int32_t value_long() { return value_ptr ? strtol(value_ptr, nullptr, 10) : 0L; }
-  static inline uint32_t value_ulong() { return value_ptr ? strtoul(value_ptr, nullptr, 10) : 0UL; }
+  #if ENABLED(GCODE_QUEUE_TOKENS)
+    static inline int32_t value_long() { return value_ptr ? (tokens ? int32_t(token_value()) : strtol(value_ptr, nullptr, 10)) : 0L; }
+    static inline uint32_t value_ulong() { return value_ptr ? (tokens ? uint32_t(int32_t(token_value())) : strtoul(value_ptr, nullptr, 10)) : 0UL; }
+  #else
+    static inline int32_t value_long() { return value_ptr ? strtol(value_ptr, nullptr, 10) : 0L; }
+    static inline uint32_t value_ulong() { return value_ptr ? strtoul(value_ptr, nullptr, 10) : 0UL; }
+  #endif
 
   // Code value for use as time
   static inline millis_t value_millis() { return value_ulong(); }
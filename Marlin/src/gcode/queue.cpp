@@ -34,6 +34,7 @@ GCodeQueue queue;
 #include "../module/planner.h"
 #include "../module/temperature.h"
 #include "../MarlinCore.h"
+#include "../feature/loop_latency.h"
 
 #if ENABLED(PRINTER_EVENT_LEDS)
   #include "../feature/leds/printer_event_leds.h"
@@ -67,8 +68,20 @@ uint8_t GCodeQueue::length = 0,  // Count of commands in the queue
         GCodeQueue::index_r = 0, // Ring buffer read position
         GCodeQueue::index_w = 0; // Ring buffer write position
 
+#if HAS_SERIAL_IN_PLACE
+  uint8_t GCodeQueue::serial_slot = 0;
+#endif
+
 char GCodeQueue::command_buffer[BUFSIZE][MAX_CMD_SIZE];
 
+#if ENABLED(GCODE_QUEUE_TOKENS)
+  uint8_t GCodeQueue::token_offset[BUFSIZE];
+#endif
+
+#if ENABLED(PLANNER_UNDERRUN_STATS)
+  uint32_t GCodeQueue::line[BUFSIZE], GCodeQueue::sd_line, GCodeQueue::current_line;
+#endif
+
 /*
  * The port that the command was received on
  */
@@ -83,6 +96,15 @@ char GCodeQueue::command_buffer[BUFSIZE][MAX_CMD_SIZE];
 // Number of characters read in the current line of serial input
 static int serial_count[NUM_SERIAL] = { 0 };
 
+/**
+ * The line check is done while characters stream in. Every stored character
+ * goes into a running XOR, and the last '*' is remembered along with the XOR
+ * up to it, so a completed line is validated without scanning it again.
+ */
+static uint8_t serial_checksum[NUM_SERIAL] = { 0 },  // XOR of the line so far
+               star_checksum[NUM_SERIAL];           // XOR of the line before the last '*'
+static int star_index[NUM_SERIAL] = { 0 };           // Index after the last '*', 0 if none
+
 bool send_ok[BUFSIZE];
 
 /**
@@ -123,6 +145,12 @@ void GCodeQueue::_commit_command(bool say_ok
   #if NUM_SERIAL > 1
     port[index_w] = p;
   #endif
+  #if ENABLED(GCODE_QUEUE_TOKENS)
+    token_offset[index_w] = parser.tokenize(command_buffer[index_w]);
+  #endif
+  #if ENABLED(PLANNER_UNDERRUN_STATS)
+    line[index_w] = say_ok ? gcode_N : sd_line; // Host lines have their N, the rest belong to the SD print
+  #endif
   #if ENABLED(POWER_LOSS_RECOVERY)
     recovery.commit_sdpos(index_w);
   #endif
@@ -130,10 +158,36 @@ void GCodeQueue::_commit_command(bool say_ok
   length++;
 }
 
+#if ENABLED(SD_BINARY_GCODE)
+
+  /**
+   * Commit a binary SD move, already stored as tokens at 'at'
+   */
+  void GCodeQueue::_commit_tokens(const uint8_t at) {
+    send_ok[index_w] = false;
+    #if NUM_SERIAL > 1
+      port[index_w] = -1;
+    #endif
+    token_offset[index_w] = at;
+    #if ENABLED(PLANNER_UNDERRUN_STATS)
+      line[index_w] = sd_line;
+    #endif
+    #if ENABLED(POWER_LOSS_RECOVERY)
+      recovery.commit_sdpos(index_w);
+    #endif
+    if (++index_w >= BUFSIZE) index_w = 0;
+    length++;
+  }
+
+#endif
+
 /**
  * Copy a command from RAM into the main command buffer.
  * Return true if the command was successfully added.
  * Return false for a full buffer, or if the 'command' is a comment.
+ * While a partial serial line is held in the write slot it keeps that slot,
+ * so the buffer is full one command sooner, at length BUFSIZE - 1. Callers
+ * retry, as they do for a full buffer.
  */
 bool GCodeQueue::_enqueue(const char* cmd, bool say_ok/*=false*/
   #if NUM_SERIAL > 1
@@ -141,6 +195,9 @@ bool GCodeQueue::_enqueue(const char* cmd, bool say_ok/*=false*/
   #endif
 ) {
   if (*cmd == ';' || length >= BUFSIZE) return false;
+  #if HAS_SERIAL_IN_PLACE
+    if (!free_write_slot()) return false;
+  #endif
   strcpy(command_buffer[index_w], cmd);
   _commit_command(say_ok
     #if NUM_SERIAL > 1
@@ -150,6 +207,25 @@ bool GCodeQueue::_enqueue(const char* cmd, bool say_ok/*=false*/
   return true;
 }
 
+#if HAS_SERIAL_IN_PLACE
+
+  /**
+   * A partially received serial line may sit in the write slot. Move it up
+   * one slot so another source can fill this one. The serial line is shorter
+   * than a whole command, so this is cheaper than always receiving into a
+   * separate buffer. Return false if there's no slot left to move it to.
+   */
+  bool GCodeQueue::free_write_slot() {
+    if (!serial_count[0] || serial_slot != index_w) return true;
+    if (length >= BUFSIZE - 1) return false;
+    const uint8_t next = index_w + 1 < BUFSIZE ? index_w + 1 : 0;
+    memcpy(command_buffer[next], command_buffer[index_w], serial_count[0]);
+    serial_slot = next;
+    return true;
+  }
+
+#endif
+
 #define ISEOL(C) ((C) == '\n' || (C) == '\r')
 
 /**
@@ -396,7 +472,12 @@ inline bool process_line_done(uint8_t &sis, char (&buff)[MAX_CMD_SIZE], int &ind
  * left on the serial port.
  */
 void GCodeQueue::get_serial_commands() {
-  static char serial_line_buffer[NUM_SERIAL][MAX_CMD_SIZE];
+  #if HAS_SERIAL_IN_PLACE
+    #define SERIAL_LINE(N) command_buffer[serial_slot]
+  #else
+    static char serial_line_buffer[NUM_SERIAL][MAX_CMD_SIZE];
+    #define SERIAL_LINE(N) serial_line_buffer[N]
+  #endif
 
   static uint8_t serial_input_state[NUM_SERIAL] = { PS_NORMAL };
 
@@ -434,41 +515,45 @@ void GCodeQueue::get_serial_commands() {
 
       const char serial_char = c;
 
+      #if HAS_SERIAL_IN_PLACE
+        if (!serial_count[0]) serial_slot = index_w;         // A new line goes into the write slot
+      #endif
+
       if (ISEOL(serial_char)) {
 
+        // Take the line check values and reset them for the next line
+        const int star = star_index[i];
+        const uint8_t star_sum = star_checksum[i];
+        star_index[i] = serial_checksum[i] = 0;
+
         // Reset our state, continue if the line was empty
-        if (process_line_done(serial_input_state[i], serial_line_buffer[i], serial_count[i]))
+        if (process_line_done(serial_input_state[i], SERIAL_LINE(i), serial_count[i]))
           continue;
 
-        char* command = serial_line_buffer[i];
+        char* command = SERIAL_LINE(i);
 
-        while (*command == ' ') command++;                   // Skip leading spaces
-        char *npos = (*command == 'N') ? command : nullptr;  // Require the N parameter to start the line
+        if (*command == 'N') {                               // Require the N parameter to start the line
 
-        if (npos) {
+          char *cpos;
+          gcode_N = strtol(command + 1, &cpos, 10);
+          while (*cpos == ' ') cpos++;                       // The command follows the line number
 
-          bool M110 = strstr_P(command, PSTR("M110")) != nullptr;
+          const bool M110 = cpos[0] == 'M' && cpos[1] == '1' && cpos[2] == '1' && cpos[3] == '0' && !NUMERIC(cpos[4]);
 
           if (M110) {
-            char* n2pos = strchr(command + 4, 'N');
-            if (n2pos) npos = n2pos;
+            char* n2pos = strchr(cpos + 4, 'N');
+            if (n2pos) gcode_N = strtol(n2pos + 1, nullptr, 10);
           }
 
-          gcode_N = strtol(npos + 1, nullptr, 10);
-
           if (gcode_N != last_N + 1 && !M110)
             return gcode_line_error(PSTR(STR_ERR_LINE_NO), i);
 
-          char *apos = strrchr(command, '*');
-          if (apos) {
-            uint8_t checksum = 0, count = uint8_t(apos - command);
-            while (count) checksum ^= command[--count];
-            if (strtol(apos + 1, nullptr, 10) != checksum)
-              return gcode_line_error(PSTR(STR_ERR_CHECKSUM_MISMATCH), i);
-          }
-          else
+          if (!star)
             return gcode_line_error(PSTR(STR_ERR_NO_CHECKSUM), i);
 
+          if (strtol(command + star, nullptr, 10) != star_sum)
+            return gcode_line_error(PSTR(STR_ERR_CHECKSUM_MISMATCH), i);
+
           last_N = gcode_N;
         }
         #if ENABLED(SDSUPPORT)
@@ -517,21 +602,66 @@ void GCodeQueue::get_serial_commands() {
         #endif
 
         // Add the command to the queue
-        _enqueue(serial_line_buffer[i], true
-          #if NUM_SERIAL > 1
-            , i
-          #endif
-        );
+        #if HAS_SERIAL_IN_PLACE
+          // The line is already in place, unless another source moved it and didn't fill the write slot
+          if (serial_slot != index_w) memcpy(command_buffer[index_w], command, strlen(command) + 1);
+          _commit_command(true);
+        #else
+          _enqueue(command, true
+            #if NUM_SERIAL > 1
+              , i
+            #endif
+          );
+        #endif
+      }
+      else {
+        int &ind = serial_count[i];
+
+        // Leading spaces aren't stored, or counted in the checksum
+        if (!ind && serial_char == ' ' && serial_input_state[i] == PS_NORMAL) continue;
+
+        const int prev_ind = ind;
+        process_stream_char(serial_char, serial_input_state[i], SERIAL_LINE(i), ind);
+        if (ind != prev_ind) {                               // The character was stored
+          if (serial_char == '*') {
+            star_index[i] = ind;
+            star_checksum[i] = serial_checksum[i];
+          }
+          serial_checksum[i] ^= serial_char;
+        }
       }
-      else
-        process_stream_char(serial_char, serial_input_state[i], serial_line_buffer[i], serial_count[i]);
 
     } // for NUM_SERIAL
   } // queue has space, serial has data
+
+  #undef SERIAL_LINE
 }
 
 #if ENABLED(SDSUPPORT)
 
+  #if ENABLED(SD_BATCH_READ)
+
+    /**
+     * Return the index of the first '\n' or '\r' in s, or n if there is none.
+     * 32-bit targets test four bytes at a time.
+     */
+    static uint16_t find_eol(const uint8_t * const s, const uint16_t n) {
+      uint16_t i = 0;
+      #ifndef __AVR__
+        constexpr uint32_t ones = 0x01010101UL, highs = 0x80808080UL;
+        for (; i + 4 <= n; i += 4) {
+          uint32_t w;
+          memcpy(&w, s + i, 4);
+          const uint32_t lf = w ^ (ones * '\n'), cr = w ^ (ones * '\r');
+          if (((lf - ones) & ~lf & highs) | ((cr - ones) & ~cr & highs)) break; // A zero byte in lf or cr
+        }
+      #endif
+      while (i < n && !ISEOL(s[i])) ++i;
+      return i;
+    }
+
+  #endif
+
   /**
    * Get lines from the SD Card until the command buffer is full
    * or until the end of the file is reached. Because this method
@@ -540,22 +670,84 @@ void GCodeQueue::get_serial_commands() {
    */
   inline void GCodeQueue::get_sdcard_commands() {
     static uint8_t sd_input_state = PS_NORMAL;
+    #if ENABLED(PLANNER_UNDERRUN_STATS)
+      // Lines are counted at '\n', so CRLF counts once, and a last line
+      // without one is counted at the end of the file
+      static bool sd_in_line = false;
+    #endif
 
     if (!IS_SD_PRINTING()) return;
 
     int sd_count = 0;
     bool card_eof = card.eof();
     while (length < BUFSIZE && !card_eof) {
-      const int16_t n = card.get();
+      #if HAS_SERIAL_IN_PLACE
+        if (!sd_count && !free_write_slot()) break;   // Keep a partial serial line ahead of the new command
+      #endif
+      #if ENABLED(SD_BATCH_READ)
+        const uint8_t *data;
+        const uint16_t count = card.get_span(data);
+        const int16_t n = count ? data[0] : -1;
+      #else
+        const int16_t n = card.get();
+      #endif
       card_eof = card.eof();
       if (n < 0 && !card_eof) { SERIAL_ERROR_MSG(STR_SD_ERR_READ); continue; }
 
-      const char sd_char = (char)n;
-      const bool is_eol = ISEOL(sd_char);
-      if (is_eol || card_eof) {
+      #if ENABLED(SD_BINARY_GCODE)
+        // A binary move record in place of a line
+        if (n >= 0x80 && !sd_count && sd_input_state == PS_NORMAL && card.flag.binary_gcode) {
+          #if ENABLED(SD_BATCH_READ)
+            card.skip(1);
+          #endif
+          #if ENABLED(PLANNER_UNDERRUN_STATS)
+            sd_line++;                                  // A record stands for a line
+          #endif
+          const uint8_t at = card.get_move(n, command_buffer[index_w]);
+          card_eof = card.eof();
+          if (at) {
+            _commit_tokens(at);
+            #if ENABLED(POWER_LOSS_RECOVERY)
+              recovery.cmd_sdpos = card.getIndex() + 1; // Prime for the NEXT command, after the record
+            #endif
+          }
+          else if (!card_eof)
+            SERIAL_ERROR_MSG(STR_SD_ERR_READ);
+          if (card_eof) card.fileHasFinished();
+          continue;
+        }
+      #endif
+
+      #if ENABLED(SD_BATCH_READ)
+
+        // Take the span up to the end of the line. Once the rest is a comment
+        // (or too long) it only has to be searched for the end of the line.
+        if (count) {
+          uint16_t i = 0;
+          for (; i < count && sd_input_state != PS_EOL && !ISEOL(data[i]); ++i)
+            process_stream_char(data[i], sd_input_state, command_buffer[index_w], sd_count);
+          if (sd_input_state == PS_EOL) i += find_eol(data + i, count - i);
+          if (i == count) {                             // The line goes on in the next span
+            card.skip(count);
+            #if ENABLED(PLANNER_UNDERRUN_STATS)
+              sd_in_line = true;
+            #endif
+            continue;
+          }
+          #if ENABLED(PLANNER_UNDERRUN_STATS)
+            sd_in_line = data[i] != '\n';
+            if (!sd_in_line) sd_line++;
+          #endif
+          card.skip(i + 1);                             // Up to and including the EOL
+        }
+        #if ENABLED(PLANNER_UNDERRUN_STATS)
+          else if (sd_in_line) {                        // End of file
+            sd_in_line = false;
+            sd_line++;
+          }
+        #endif
 
-        // Reset stream state, terminate the buffer, and commit a non-empty command
-        if (!is_eol && sd_count) ++sd_count;          // End of file with no newline
+        // End of line or end of file
         if (!process_line_done(sd_input_state, command_buffer[index_w], sd_count)) {
           _commit_command(false);
           #if ENABLED(POWER_LOSS_RECOVERY)
@@ -563,10 +755,37 @@ void GCodeQueue::get_serial_commands() {
           #endif
         }
 
-        if (card_eof) card.fileHasFinished();         // Handle end of file reached
-      }
-      else
-        process_stream_char(sd_char, sd_input_state, command_buffer[index_w], sd_count);
+        if (card_eof) card.fileHasFinished();
+
+      #else
+
+        const char sd_char = (char)n;
+        const bool is_eol = ISEOL(sd_char);
+        if (is_eol || card_eof) {
+
+          // Reset stream state, terminate the buffer, and commit a non-empty command
+          if (!is_eol && sd_count) ++sd_count;          // End of file with no newline
+          #if ENABLED(PLANNER_UNDERRUN_STATS)
+            if (sd_char == '\n' || (card_eof && (sd_in_line || n >= 0))) sd_line++;
+            sd_in_line = !card_eof && sd_char != '\n';
+          #endif
+          if (!process_line_done(sd_input_state, command_buffer[index_w], sd_count)) {
+            _commit_command(false);
+            #if ENABLED(POWER_LOSS_RECOVERY)
+              recovery.cmd_sdpos = card.getIndex();     // Prime for the NEXT _commit_command
+            #endif
+          }
+
+          if (card_eof) card.fileHasFinished();         // Handle end of file reached
+        }
+        else {
+          process_stream_char(sd_char, sd_input_state, command_buffer[index_w], sd_count);
+          #if ENABLED(PLANNER_UNDERRUN_STATS)
+            sd_in_line = true;
+          #endif
+        }
+
+      #endif
 
     }
   }
@@ -599,6 +818,12 @@ void GCodeQueue::advance() {
   // Return if the G-code buffer is empty
   if (!length) return;
 
+  #if ENABLED(PLANNER_UNDERRUN_STATS)
+    CRITICAL_SECTION_START();   // The stepper ISR reads it when the planner runs dry
+    current_line = line[index_r];
+    CRITICAL_SECTION_END();
+  #endif
+
   #if ENABLED(SDSUPPORT)
 
     if (card.flag.saving) {
@@ -624,17 +849,17 @@ void GCodeQueue::advance() {
         // Write the string from the read buffer to SD
         card.write_command(command);
         if (card.flag.logging)
-          gcode.process_next_command(); // The card is saving because it's logging
+          LOOP_TRACE(LOOP_STEP_COMMAND, gcode.process_next_command()); // The card is saving because it's logging
         else
           ok_to_send();
       }
     }
     else
-      gcode.process_next_command();
+      LOOP_TRACE(LOOP_STEP_COMMAND, gcode.process_next_command());
 
   #else
 
-    gcode.process_next_command();
+    LOOP_TRACE(LOOP_STEP_COMMAND, gcode.process_next_command());
 
   #endif // SDSUPPORT
 
@@ -28,6 +28,11 @@
 
 #include "../inc/MarlinConfig.h"
 
+// With a single serial port, lines are received directly into the command queue
+#if NUM_SERIAL == 1 && DISABLED(BINARY_FILE_TRANSFER)
+  #define HAS_SERIAL_IN_PLACE 1
+#endif
+
 class GCodeQueue {
 public:
   /**
@@ -51,6 +56,16 @@ public:
 
   static char command_buffer[BUFSIZE][MAX_CMD_SIZE];
 
+  #if ENABLED(GCODE_QUEUE_TOKENS)
+    static uint8_t token_offset[BUFSIZE];  // Where a command's tokens start, 0 if it's only text
+  #endif
+
+  #if ENABLED(PLANNER_UNDERRUN_STATS)
+    static uint32_t line[BUFSIZE],  // Each command's line: N from the host, or the line in the SD file
+                    sd_line,        // Lines read so far from the SD file
+                    current_line;   // Line of the command being processed
+  #endif
+
   /*
    * The port that the command was received on
    */
@@ -127,12 +142,21 @@ private:
 
   static uint8_t index_w;  // Ring buffer write position
 
+  #if HAS_SERIAL_IN_PLACE
+    static uint8_t serial_slot;  // Ring buffer slot of the serial line being received
+    static bool free_write_slot();
+  #endif
+
   static void get_serial_commands();
 
   #if ENABLED(SDSUPPORT)
     static void get_sdcard_commands();
   #endif
 
+  #if ENABLED(SD_BINARY_GCODE)
+    static void _commit_tokens(const uint8_t at);
+  #endif
+
   static void _commit_command(bool say_ok
     #if NUM_SERIAL > 1
       , int16_t p=-1
@@ -0,0 +1,48 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../../inc/MarlinConfig.h"
+
+#if ENABLED(STEPPER_ISR_PROFILE)
+
+#include "../gcode.h"
+#include "../../feature/stepper_profile.h"
+
+/**
+ * M940: Report the stepper ISR load profile
+ *
+ * Each phase of the stepper ISR is listed with its call count, its longest
+ * run, and a histogram of run times in CPU cycles. Multistep counts how many
+ * pulse phases ran at each steps-per-ISR multiplier. Loop guard hits are ISRs
+ * that gave up on pulse timing because the MCU couldn't keep up. With
+ * STEP_TIMER_CHECK, the largest difference between the table step interval
+ * and a division is also listed. With STEP_TIMING_QUEUE, the block phases
+ * taken from the timing queue and those the ISR had to work out are counted.
+ *
+ *   R : Reset the profile after reporting
+ */
+void GcodeSuite::M940() {
+  StepperProfile::report();
+  if (parser.seen('R')) StepperProfile::reset();
+}
+
+#endif // STEPPER_ISR_PROFILE
@@ -0,0 +1,53 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../../inc/MarlinConfig.h"
+
+#if HAS_PLANNER_REPORT
+
+#include "../gcode.h"
+#include "../../module/planner.h"
+
+/**
+ * M941: Report planner statistics
+ *
+ * Look-ahead: how many blocks the look-ahead passes visited for each
+ * queued block, on average and at worst.
+ *
+ * Fixed-point check: the largest difference between the fixed-point and
+ * float trapezoids, in steps, steps/s and STEP timer ticks.
+ *
+ * Underruns: how often the stepper found the buffer empty during a print,
+ * the time spent empty in total and at worst, the G-code line (N from the
+ * host, or the line in the SD file) that was being processed at the worst
+ * one, and the fewest moves queued when a block was taken. SD lines end
+ * at '\n'. After a seek (M26, M24 S, power-loss resume) they count from
+ * the new position, except in .gcb files, which are replayed from the start.
+ *
+ *   R : Reset the statistics after reporting
+ */
+void GcodeSuite::M941() {
+  planner.report_stats();
+  if (parser.seen('R')) planner.reset_stats();
+}
+
+#endif // HAS_PLANNER_REPORT
@@ -20,31 +20,25 @@
  *
  */
 
-#ifdef __PLAT_LINUX__
+#include "../../inc/MarlinConfig.h"
 
-#include "IOLoggerCSV.h"
+#if ENABLED(ANYCUBIC_TFT_TX_QUEUE)
 
-IOLoggerCSV::IOLoggerCSV(std::string filename) {
-  file.open(filename);
-}
-
-IOLoggerCSV::~IOLoggerCSV() {
-  file.close();
-}
-
-void IOLoggerCSV::log(GpioEvent ev) {
-  std::lock_guard<std::mutex> lock(vector_lock);
-  events.push_back(ev); //minimal impact to signal handler
-}
+#include "../gcode.h"
+#include "../../lcd/HardwareSerial.h"
 
-void IOLoggerCSV::flush() {
-  { std::lock_guard<std::mutex> lock(vector_lock);
-    while (!events.empty()) {
-      file << events.front().timestamp << ", "<< events.front().pin_id << ", " << events.front().event << std::endl;
-      events.pop_front();
-    }
-  }
-  file.flush();
+/**
+ * M942: Report TFT output queue stalls
+ *
+ * Stalls: writes that waited for room in the queue, and for how long.
+ * Deferred: TFT commands left waiting until the queue had drained.
+ * Copies: flash texts copied because every reference slot was in use.
+ *
+ *   R : Reset the counters after reporting
+ */
+void GcodeSuite::M942() {
+  HardwareSerial.report_tx_stats();
+  if (parser.seen('R')) HardwareSerial.reset_tx_stats();
 }
 
-#endif // __PLAT_LINUX__
+#endif // ANYCUBIC_TFT_TX_QUEUE
@@ -19,22 +19,26 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  *
  */
-#pragma once
 
-#include <mutex>
-#include <list>
-#include <fstream>
-#include "Gpio.h"
+#include "../../inc/MarlinConfig.h"
 
-class IOLoggerCSV: public IOLogger {
-public:
-  IOLoggerCSV(std::string filename);
-  virtual ~IOLoggerCSV();
-  void flush();
-  void log(GpioEvent ev);
+#if ENABLED(IDLE_TASK_SCHEDULER)
 
-private:
-  std::ofstream file;
-  std::list<GpioEvent> events;
-  std::mutex vector_lock;
-};
+#include "../gcode.h"
+#include "../../feature/idle_scheduler.h"
+
+/**
+ * M943: Report idle task run times
+ *
+ * Each task is listed with its period in ms, how many times it ran, and its
+ * average and longest run in microseconds. Deferred counts the times a task
+ * was held back because the planner was running low.
+ *
+ *   R : Reset the counters after reporting
+ */
+void GcodeSuite::M943() {
+  idle_scheduler.report();
+  if (parser.seen('R')) idle_scheduler.reset();
+}
+
+#endif // IDLE_TASK_SCHEDULER
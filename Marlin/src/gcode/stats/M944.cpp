@@ -0,0 +1,53 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../../inc/MarlinConfig.h"
+
+#if ENABLED(LOOP_LATENCY_TRACE)
+
+#include "../gcode.h"
+#include "../../feature/loop_latency.h"
+
+/**
+ * M944: Report main loop latencies
+ *
+ * Each step of loop() and idle() is listed with its call count, rolling
+ * average and longest call in microseconds, the lowest number of planned
+ * moves seen around a call, and the calls that left the planner empty.
+ * Waits a G-code asks for (M400, G4, M109, homing...) aren't underruns.
+ *
+ * Steps nest. Queue advance includes Command, and a command that waits
+ * runs the idle() steps inside both, so their times and underruns also
+ * show up in Queue advance and Command.
+ *
+ *   S<seconds> : Report every S seconds, S0 to stop
+ *   R          : Reset the counters after reporting
+ */
+void GcodeSuite::M944() {
+  if (parser.seenval('S'))
+    loop_latency.set_auto_report_interval(parser.value_byte());
+  else
+    loop_latency.report();
+  if (parser.seen('R')) loop_latency.reset();
+}
+
+#endif // LOOP_LATENCY_TRACE
@@ -97,6 +97,13 @@
   #define HAS_RESUME_CONTINUE 1
 #endif
 
+#if ANY(PLANNER_LOOKAHEAD_STATS, PLANNER_FIXED_POINT_CHECK, PLANNER_UNDERRUN_STATS)
+  #define HAS_PLANNER_REPORT 1
+#endif
+#if EITHER(PLANNER_UNDERRUN_STATS, LOOP_LATENCY_TRACE)
+  #define HAS_GCODE_WAIT 1
+#endif
+
 #if ANY(BLINKM, RGB_LED, RGBW_LED, PCA9632, PCA9533, NEOPIXEL_LED)
   #define HAS_COLOR_LEDS 1
 #endif
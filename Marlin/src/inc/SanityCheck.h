@@ -688,6 +688,10 @@ static_assert(Y_MAX_LENGTH >= Y_BED_SIZE, "Movement bounds (Y_MIN_POS, Y_MAX_POS
   #endif
 #endif
 
+#if ENABLED(SD_DIR_INDEX) && SD_DIR_INDEX_SIZE < 1
+  #error "SD_DIR_INDEX_SIZE must be 1 or greater."
+#endif
+
 #if defined(EVENT_GCODE_SD_STOP) && DISABLED(NOZZLE_PARK_FEATURE)
   static_assert(nullptr == strstr(EVENT_GCODE_SD_STOP, "G27"), "NOZZLE_PARK_FEATURE is required to use G27 in EVENT_GCODE_SD_STOP.");
 #endif
@@ -1358,6 +1362,15 @@ static_assert(Y_MAX_LENGTH >= Y_BED_SIZE, "Movement bounds (Y_MIN_POS, Y_MAX_POS
   #error "G26_MESH_VALIDATION requires MESH_BED_LEVELING, AUTO_BED_LEVELING_BILINEAR, or AUTO_BED_LEVELING_UBL."
 #endif
 
+#if ENABLED(LEVELED_SEGMENT_ADAPTIVE)
+  #if NONE(AUTO_BED_LEVELING_BILINEAR, MESH_BED_LEVELING) || DISABLED(SEGMENT_LEVELED_MOVES) || IS_KINEMATIC
+    #error "LEVELED_SEGMENT_ADAPTIVE requires SEGMENT_LEVELED_MOVES with AUTO_BED_LEVELING_BILINEAR or MESH_BED_LEVELING on a Cartesian machine."
+  #elif !defined(LEVELED_SEGMENT_TOLERANCE)
+    #error "LEVELED_SEGMENT_ADAPTIVE requires LEVELED_SEGMENT_TOLERANCE."
+  #endif
+  static_assert(LEVELED_SEGMENT_TOLERANCE > 0, "LEVELED_SEGMENT_TOLERANCE must be greater than 0.");
+#endif
+
 #if ENABLED(MESH_EDIT_GFX_OVERLAY) && !(ENABLED(AUTO_BED_LEVELING_UBL) && HAS_GRAPHICAL_LCD)
   #error "MESH_EDIT_GFX_OVERLAY requires AUTO_BED_LEVELING_UBL and a Graphical LCD."
 #endif
@@ -2015,6 +2028,19 @@ static_assert(Y_MAX_LENGTH >= Y_BED_SIZE, "Movement bounds (Y_MIN_POS, Y_MAX_POS
   #error "Please select only one of SDCARD, FLASH, or SRAM_EEPROM_EMULATION."
 #endif
 
+/**
+ * EEPROM Async Save requirements
+ */
+#if ENABLED(EEPROM_ASYNC_SAVE)
+  #if DISABLED(EEPROM_SETTINGS)
+    #error "EEPROM_ASYNC_SAVE requires EEPROM_SETTINGS."
+  #elif ANY(SDCARD_EEPROM_EMULATION, FLASH_EEPROM_EMULATION)
+    #error "EEPROM_ASYNC_SAVE is not compatible with SDCARD_EEPROM_EMULATION or FLASH_EEPROM_EMULATION."
+  #elif !WITHIN(EEPROM_ASYNC_SAVE_BYTES, 1, 255)
+    #error "EEPROM_ASYNC_SAVE_BYTES must be from 1 to 255."
+  #endif
+#endif
+
 /**
  * Make sure only one display is enabled
  */
@@ -2493,10 +2519,48 @@ static_assert(   _ARR_TEST(3,0) && _ARR_TEST(3,1) && _ARR_TEST(3,2)
   #error "CNC_COORDINATE_SYSTEMS is incompatible with NO_WORKSPACE_OFFSETS."
 #endif
 
+#if ENABLED(GCODE_QUEUE_TOKENS)
+  #if DISABLED(FASTER_GCODE_PARSER)
+    #error "GCODE_QUEUE_TOKENS requires FASTER_GCODE_PARSER."
+  #elif MAX_CMD_SIZE > 255
+    #error "GCODE_QUEUE_TOKENS requires MAX_CMD_SIZE 255 or less."
+  #endif
+#endif
+
+#if ENABLED(SD_BINARY_GCODE)
+  #if DISABLED(GCODE_QUEUE_TOKENS)
+    #error "SD_BINARY_GCODE requires GCODE_QUEUE_TOKENS."
+  #elif MAX_CMD_SIZE < 41
+    #error "SD_BINARY_GCODE requires MAX_CMD_SIZE 41 or more."
+  #endif
+#endif
+
+#if ENABLED(ANYCUBIC_TFT_TX_QUEUE)
+  #if DISABLED(ANYCUBIC_TOUCHSCREEN)
+    #error "ANYCUBIC_TFT_TX_QUEUE requires ANYCUBIC_TOUCHSCREEN."
+  #elif TFT_TX_BUFFER_SIZE > 256 || TFT_TX_BUFFER_SIZE < 2 || !IS_POWER_OF_2(TFT_TX_BUFFER_SIZE)
+    #error "TFT_TX_BUFFER_SIZE must be a power of 2 from 2 to 256."
+  #elif TFT_TX_PGM_QUEUE > 128 || !IS_POWER_OF_2(TFT_TX_PGM_QUEUE)
+    #error "TFT_TX_PGM_QUEUE must be a power of 2 up to 128."
+  #endif
+#endif
+
+#if ENABLED(SD_BATCH_READ) && DISABLED(SD_READ_AHEAD)
+  #error "SD_BATCH_READ requires SD_READ_AHEAD."
+#endif
+
 #if !BLOCK_BUFFER_SIZE || !IS_POWER_OF_2(BLOCK_BUFFER_SIZE)
   #error "BLOCK_BUFFER_SIZE must be a power of 2."
 #endif
 
+#if ENABLED(BLOCK_BUFFER_AUTO_SIZE)
+  #if !IS_POWER_OF_2(BLOCK_BUFFER_SIZE_MAX) || BLOCK_BUFFER_SIZE_MAX < BLOCK_BUFFER_SIZE
+    #error "BLOCK_BUFFER_SIZE_MAX must be a power of 2 no smaller than BLOCK_BUFFER_SIZE."
+  #elif BLOCK_BUFFER_SIZE_MAX > 64
+    #error "BLOCK_BUFFER_SIZE_MAX must be 64 or less."
+  #endif
+#endif
+
 #if ENABLED(LED_CONTROL_MENU) && DISABLED(ULTIPANEL)
   #error "LED_CONTROL_MENU requires an LCD controller."
 #endif
@@ -2523,6 +2587,14 @@ static_assert(   _ARR_TEST(3,0) && _ARR_TEST(3,1) && _ARR_TEST(3,2)
   #error "BACKUP_POWER_SUPPLY requires a POWER_LOSS_PIN."
 #endif
 
+#if ENABLED(POWER_LOSS_JOURNAL)
+  #if DISABLED(POWER_LOSS_RECOVERY)
+    #error "POWER_LOSS_JOURNAL requires POWER_LOSS_RECOVERY."
+  #elif !WITHIN(POWER_LOSS_JOURNAL_BLOCKS, 1, 255)
+    #error "POWER_LOSS_JOURNAL_BLOCKS must be from 1 to 255."
+  #endif
+#endif
+
 #if ENABLED(Z_STEPPER_AUTO_ALIGN)
   #if NUM_Z_STEPPER_DRIVERS <= 1
     #error "Z_STEPPER_AUTO_ALIGN requires NUM_Z_STEPPER_DRIVERS greater than 1."
@@ -2833,3 +2905,36 @@ static_assert(   _ARR_TEST(3,0) && _ARR_TEST(3,1) && _ARR_TEST(3,2)
 #if SAVED_POSITIONS > 256
   #error "SAVED_POSITIONS must be an integer from 0 to 256."
 #endif
+
+#if ENABLED(LINUX_VIRTUAL_CLOCK) && !defined(__PLAT_LINUX__)
+  #error "LINUX_VIRTUAL_CLOCK requires the linux_native environment."
+#elif ENABLED(LINUX_BENCHMARK) && DISABLED(LINUX_VIRTUAL_CLOCK)
+  #error "LINUX_BENCHMARK requires LINUX_VIRTUAL_CLOCK."
+#endif
+
+/**
+ * Step timer table
+ */
+#if BOTH(STEP_TIMER_TABLE, STEP_TIMER_RECIPROCAL)
+  #error "Enable only one of STEP_TIMER_TABLE or STEP_TIMER_RECIPROCAL."
+#elif EITHER(STEP_TIMER_TABLE, STEP_TIMER_RECIPROCAL)
+  #ifdef __AVR__
+    #error "STEP_TIMER_TABLE and STEP_TIMER_RECIPROCAL are for 32-bit boards. AVR uses speed_lookuptable.h."
+  #elif STEP_TIMER_TABLE_SIZE != 16 && STEP_TIMER_TABLE_SIZE != 64 && STEP_TIMER_TABLE_SIZE != 256
+    #error "STEP_TIMER_TABLE_SIZE must be 16, 64 or 256."
+  #endif
+#endif
+#if ENABLED(STEP_TIMER_CHECK)
+  #if NONE(STEP_TIMER_TABLE, STEP_TIMER_RECIPROCAL)
+    #error "STEP_TIMER_CHECK requires STEP_TIMER_TABLE or STEP_TIMER_RECIPROCAL."
+  #elif DISABLED(STEPPER_ISR_PROFILE)
+    #error "STEP_TIMER_CHECK requires STEPPER_ISR_PROFILE."
+  #endif
+#endif
+
+/**
+ * Step timing queue
+ */
+#if ENABLED(STEP_TIMING_QUEUE) && (STEP_TIMING_QUEUE_SIZE < 2 || STEP_TIMING_QUEUE_SIZE > 128 || !IS_POWER_OF_2(STEP_TIMING_QUEUE_SIZE))
+  #error "STEP_TIMING_QUEUE_SIZE must be a power of 2 from 2 to 128."
+#endif
@@ -58,7 +58,39 @@ struct ring_buffer
 
 #if defined(UBRR3H)
 ring_buffer rx_buffer_ajg = {{0}, 0, 0};
+#if DISABLED(ANYCUBIC_TFT_TX_QUEUE)
 ring_buffer tx_buffer_ajg = {{0}, 0, 0};
+#endif
+#endif
+
+#if ENABLED(ANYCUBIC_TFT_TX_QUEUE)
+
+// Output queue for the TFT. head and tail count the bytes written and sent,
+// wrapping at 256, so a string queued from flash can note the byte it goes
+// before and the interrupt sends it when the queue gets there. Only the
+// pointer is queued, so menu texts take no room in the byte buffer.
+#define TX_MASK (TFT_TX_BUFFER_SIZE - 1)
+
+struct tx_pgm_t
+{
+  const char *str;
+  uint8_t at;
+};
+
+struct tx_queue_t
+{
+  volatile uint8_t buffer[TFT_TX_BUFFER_SIZE];
+  volatile uint8_t head, tail;
+  volatile tx_pgm_t pgm[TFT_TX_PGM_QUEUE];
+  volatile uint8_t pgm_head, pgm_tail;
+};
+
+static tx_queue_t tx_queue;
+tft_tx_stats_t HardwareSerialClass::tx_stats;
+
+FORCE_INLINE uint8_t tx_used() { return uint8_t(tx_queue.head - tx_queue.tail); }
+FORCE_INLINE uint8_t tx_pgm_used() { return uint8_t(tx_queue.pgm_head - tx_queue.pgm_tail); }
+
 #endif
 
 inline void store_char(unsigned char c, ring_buffer *buffer)
@@ -97,6 +129,25 @@ ISR(USART3_RX_vect)
 #ifdef USART3_UDRE_vect
 ISR(USART3_UDRE_vect)
 {
+#if ENABLED(ANYCUBIC_TFT_TX_QUEUE)
+  // A flash string that goes before the next byte
+  if (tx_queue.pgm_head != tx_queue.pgm_tail)
+  {
+    volatile tx_pgm_t &p = tx_queue.pgm[tx_queue.pgm_tail % TFT_TX_PGM_QUEUE];
+    if (p.at == tx_queue.tail)
+    {
+      const char *str = p.str;
+      UDR3 = pgm_read_byte(str++);
+      p.str = str;
+      if (!pgm_read_byte(str)) tx_queue.pgm_tail++;
+      return;
+    }
+  }
+  if (tx_queue.head == tx_queue.tail)
+    cbi(UCSR3B, UDRIE3);
+  else
+    UDR3 = tx_queue.buffer[tx_queue.tail++ & TX_MASK];
+#else
   if (tx_buffer_ajg.head == tx_buffer_ajg.tail)
   {
     cbi(UCSR3B, UDRIE3);
@@ -109,6 +160,7 @@ ISR(USART3_UDRE_vect)
 
     UDR3 = c;
   }
+#endif
 }
 #endif
 
@@ -230,8 +282,13 @@ try_again:
 void HardwareSerialClass::end()
 {
   // wait for transmission of outgoing data
+#if ENABLED(ANYCUBIC_TFT_TX_QUEUE)
+  while (tx_used() || tx_pgm_used())
+    ;
+#else
   while (_tx_buffer->head != _tx_buffer->tail)
     ;
+#endif
 
   cbi(*_ucsrb, _rxen);
   cbi(*_ucsrb, _txen);
@@ -282,6 +339,70 @@ void HardwareSerialClass::flush()
   transmitting = false;
 }
 
+#if ENABLED(ANYCUBIC_TFT_TX_QUEUE)
+
+size_t HardwareSerialClass::write(uint8_t c)
+{
+  // A TFT command is only read when its whole reply fits (see tx_ready),
+  // so only messages sent unasked can still wait here. Count them.
+  if (tx_used() >= TX_MASK)
+  {
+    const uint32_t start = micros();
+    while (tx_used() >= TX_MASK)
+      ;
+    const uint32_t us = micros() - start;
+    tx_stats.stalls++;
+    tx_stats.stall_us += us;
+    NOLESS(tx_stats.stall_max_us, us);
+  }
+
+  tx_queue.buffer[tx_queue.head & TX_MASK] = c;
+  tx_queue.head++;
+  NOLESS(tx_stats.max_used, tx_used());
+
+  sbi(*_ucsrb, _udrie);
+  transmitting = true;
+  sbi(*_ucsra, TXC0);
+
+  return 1;
+}
+
+// Queue a string in flash by reference, or copy it if no slot is free
+void HardwareSerialClass::writePGM(const char *str)
+{
+  if (!pgm_read_byte(str)) return;
+
+  if (tx_pgm_used() >= TFT_TX_PGM_QUEUE)
+  {
+    tx_stats.pgm_copies++;
+    for (char ch; (ch = pgm_read_byte(str)); str++) write(ch);
+    return;
+  }
+
+  volatile tx_pgm_t &p = tx_queue.pgm[tx_queue.pgm_head % TFT_TX_PGM_QUEUE];
+  p.str = str;
+  p.at = tx_queue.head;
+  tx_queue.pgm_head++;
+
+  sbi(*_ucsrb, _udrie);
+  transmitting = true;
+  sbi(*_ucsra, TXC0);
+}
+
+// Is there room for a reply of this many bytes?
+bool HardwareSerialClass::tx_ready(const uint8_t room)
+{
+  return tx_used() <= TX_MASK - room && tx_pgm_used() <= TFT_TX_PGM_QUEUE / 2;
+}
+
+void HardwareSerialClass::report_tx_stats()
+{
+  SERIAL_ECHOLNPAIR("TFT TX stalls:", tx_stats.stalls, " total:", tx_stats.stall_us, "us max:", tx_stats.stall_max_us, "us");
+  SERIAL_ECHOLNPAIR("TFT TX deferred:", tx_stats.deferred, " pgm copies:", tx_stats.pgm_copies, " max used:", tx_stats.max_used, "/", TFT_TX_BUFFER_SIZE - 1);
+}
+
+#else
+
 size_t HardwareSerialClass::write(uint8_t c)
 {
   int i = (_tx_buffer->head + 1) % SERIAL_BUFFER_SIZE;
@@ -303,13 +424,20 @@ size_t HardwareSerialClass::write(uint8_t c)
   return 1;
 }
 
+#endif // ANYCUBIC_TFT_TX_QUEUE
+
 HardwareSerialClass::operator bool()
 {
   return true;
 }
 
 #if defined(UBRR3H)
-HardwareSerialClass HardwareSerial(&rx_buffer_ajg, &tx_buffer_ajg, &UBRR3H, &UBRR3L, &UCSR3A, &UCSR3B, &UCSR3C, &UDR3, RXEN3, TXEN3, RXCIE3, UDRIE3, U2X3);
+#if ENABLED(ANYCUBIC_TFT_TX_QUEUE)
+  #define TX_BUFFER nullptr // Output goes through tx_queue
+#else
+  #define TX_BUFFER &tx_buffer_ajg
+#endif
+HardwareSerialClass HardwareSerial(&rx_buffer_ajg, TX_BUFFER, &UBRR3H, &UBRR3L, &UCSR3A, &UCSR3B, &UCSR3C, &UDR3, RXEN3, TXEN3, RXCIE3, UDRIE3, U2X3);
 #endif
 
 #endif
@@ -32,6 +32,18 @@
 
 struct ring_buffer;
 
+#if ENABLED(ANYCUBIC_TFT_TX_QUEUE)
+typedef struct
+{
+  uint16_t stalls;        // Writes that had to wait for a full queue
+  uint32_t stall_us,      // Time spent waiting, in total and at worst
+           stall_max_us;
+  uint16_t deferred;      // TFT commands held back until the queue drained, once each (saturates)
+  uint16_t pgm_copies;    // Flash strings copied because no slot was free
+  uint8_t max_used;       // Most bytes ever waiting to be sent
+} tft_tx_stats_t;
+#endif
+
 class HardwareSerialClass : public Stream
 {
 private:
@@ -70,6 +82,13 @@ public:
   inline size_t write(int n) { return write((uint8_t)n); }
   using Print::write; // pull in write(str) and write(buf, size) from Print
   operator bool();
+#if ENABLED(ANYCUBIC_TFT_TX_QUEUE)
+  static tft_tx_stats_t tx_stats;
+  void writePGM(const char *str);
+  bool tx_ready(const uint8_t room);
+  void report_tx_stats();
+  void reset_tx_stats() { memset(&tx_stats, 0, sizeof(tx_stats)); }
+#endif
 };
 
 // Define config for Serial.begin(baud, config);
@@ -133,12 +152,16 @@ const char newSucc[] PROGMEM = "OK";
 
 FORCE_INLINE void HardwareSerialprintPGM(const char *str)
 {
+#if ENABLED(ANYCUBIC_TFT_TX_QUEUE)
+  HardwareSerial.writePGM(str);
+#else
   char ch = pgm_read_byte(str);
   while (ch)
   {
     HardwareSerial.write(ch);
     ch = pgm_read_byte(++str);
   }
+#endif
 }
 
 #endif
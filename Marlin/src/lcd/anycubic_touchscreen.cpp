@@ -41,6 +41,19 @@
 #include "anycubic_touchscreen.h"
 #include "HardwareSerial.h"
 
+#if ENABLED(ANYCUBIC_TFT_TX_QUEUE)
+  // Longest reply to a TFT command: an A8 file list page of four folders,
+  // each sent as "/" + 8.3 name and "/" + long name, between "FN " and "END".
+  // Texts in flash are counted as bytes in case they have to be copied.
+  #if ENABLED(KNUTWURST_DGUS2_TFT)
+    #define TFT_FILE_ENTRY_MAX (1 + 12 + 4 + 2 + 1 + LONG_FILENAME_LENGTH - 1 + 6 + 2)
+  #else
+    #define TFT_FILE_ENTRY_MAX (1 + 12 + 2 + 1 + LONG_FILENAME_LENGTH - 1 + 2)
+  #endif
+  #define TFT_TX_REPLY_MAX (5 + 4 * TFT_FILE_ENTRY_MAX + 5)
+  static_assert(TFT_TX_REPLY_MAX < TFT_TX_BUFFER_SIZE, "A TFT file list page doesn't fit in TFT_TX_BUFFER_SIZE. Disable SCROLL_LONG_FILENAMES or ANYCUBIC_TFT_TX_QUEUE.");
+#endif
+
 char _conv[8];
 
 #if ENABLED(KNUTWURST_TFT_LEVELING)
@@ -525,18 +538,21 @@ void AnycubicTouchscreenClass::ParkAfterStop()
 
 int AnycubicTouchscreenClass::CodeValueInt()
 {
-  return (atoi(&TFTcmdbuffer[TFTbufindr][TFTstrchr_pointer - TFTcmdbuffer[TFTbufindr] + 1]));
+  return atoi(TFTstrchr_pointer + 1);
 }
 
 float AnycubicTouchscreenClass::CodeValue()
 {
-  return (strtod(&TFTcmdbuffer[TFTbufindr][TFTstrchr_pointer - TFTcmdbuffer[TFTbufindr] + 1], NULL));
+  return strtod(TFTstrchr_pointer + 1, NULL);
 }
 
 bool AnycubicTouchscreenClass::CodeSeen(char code)
 {
-  TFTstrchr_pointer = strchr(TFTcmdbuffer[TFTbufindr], code);
-  return (TFTstrchr_pointer != NULL); //Return True if a character was found
+  // Letters were located while the line came in (see ScanCommandChar)
+  const uint8_t i = code - 'A';
+  if (i >= COUNT(TFTcodepos) || !TFTcodepos[i]) return false;
+  TFTstrchr_pointer = &TFTcmdbuffer[TFTbufindw][TFTcodepos[i] - 1];
+  return true;
 }
 
 void AnycubicTouchscreenClass::HandleSpecialMenu()
@@ -707,6 +723,14 @@ void AnycubicTouchscreenClass::HandleSpecialMenu()
   {
     SpecialMenu = false;
   }
+  #if ENABLED(PLANNER_UNDERRUN_STATS)
+    else if ((strcasestr_P(currentTouchscreenSelection, PSTR("<Underruns")) != NULL)
+    || (strcasestr_P(currentTouchscreenSelection, PSTR(SM_UNDERRUN_S)) != NULL))
+    {
+      SERIAL_ECHOLNPGM("Special Menu: Underrun Stats");
+      planner.report_stats();
+    }
+  #endif
   else if ((strcasestr_P(currentTouchscreenSelection, PSTR(SM_BACK_L)) != NULL)
   || (strcasestr_P(currentTouchscreenSelection, PSTR(SM_BACK_S)) != NULL))
   {
@@ -962,6 +986,14 @@ void AnycubicTouchscreenClass::PrintList()
       break;
 
     case 12: // Page 3
+      #if ENABLED(PLANNER_UNDERRUN_STATS)
+      {
+        String underrunBuffer = SM_UNDERRUN_L;
+        underrunBuffer.replace("XXX", String(planner.get_underrun_stats().count));
+        HARDWARE_SERIAL_PROTOCOLLNPGM(SM_UNDERRUN_S);
+        HARDWARE_SERIAL_PROTOCOLLN(underrunBuffer);
+      }
+      #endif
       HARDWARE_SERIAL_PROTOCOLLNPGM(SM_EXIT_S);
       HARDWARE_SERIAL_PROTOCOLLNPGM(SM_EXIT_L);
       break;
@@ -1128,11 +1160,17 @@ void AnycubicTouchscreenClass::CheckSDCardChange()
 #endif
 }
 
+void AnycubicTouchscreenClass::TemperatureUpdated()
+{
+  CheckHeaterError();
+}
+
 void AnycubicTouchscreenClass::CheckHeaterError()
 {
+  // Called once per new temperature reading
   if ((thermalManager.degHotend(0) < 5) || (thermalManager.degHotend(0) > 290))
   {
-    if (HeaterCheckCount > 60000)
+    if (HeaterCheckCount > 60)
     {
       HeaterCheckCount = 0;
       //HARDWARE_SERIAL_PROTOCOLPGM("J10"); // J10 Hotend temperature abnormal
@@ -1148,7 +1186,22 @@ void AnycubicTouchscreenClass::CheckHeaterError()
   }
 }
 
-void AnycubicTouchscreenClass::StateHandler()
+uint8_t AnycubicTouchscreenClass::EventFlags()
+{
+  uint8_t flags = 0;
+  #ifdef SDSUPPORT
+    if (IS_SD_INSERTED()) flags |= ANYCUBIC_TFT_EVENT_SD_INSERTED;
+    if (card.isPrinting()) flags |= ANYCUBIC_TFT_EVENT_PRINTING;
+    if (card.isFileOpen()) flags |= ANYCUBIC_TFT_EVENT_FILE_OPEN;
+  #endif
+  if (planner.movesplanned()) flags |= ANYCUBIC_TFT_EVENT_MOVES_QUEUED;
+  #ifdef ANYCUBIC_FILAMENT_RUNOUT_SENSOR
+    if (FilamentTestStatus) flags |= ANYCUBIC_TFT_EVENT_FILAMENT;
+  #endif
+  return flags;
+}
+
+void AnycubicTouchscreenClass::StateHandler(const bool entered)
 {
   switch (TFTstate)
   {
@@ -1200,11 +1253,20 @@ void AnycubicTouchscreenClass::StateHandler()
       #endif
     break;
     case ANYCUBIC_TFT_STATE_SDPAUSE_REQ:
-      HARDWARE_SERIAL_PROTOCOLPGM("J18");
-      HARDWARE_SERIAL_ENTER();
+      // J18 is sent when the request comes in and again when the pause is done
+      if (entered)
+      {
+        HARDWARE_SERIAL_PROTOCOLPGM("J18");
+        HARDWARE_SERIAL_ENTER();
+      }
       #ifdef SDSUPPORT
         if ((!card.isPrinting()) && (!planner.movesplanned()))
         {
+          if (!entered)
+          {
+            HARDWARE_SERIAL_PROTOCOLPGM("J18");
+            HARDWARE_SERIAL_ENTER();
+          }
           if (ai3m_pause_state < 2)
           {
             // no flags, this is a regular pause.
@@ -1238,10 +1300,19 @@ void AnycubicTouchscreenClass::StateHandler()
     break;
     case ANYCUBIC_TFT_STATE_SDSTOP_REQ:
       #ifdef SDSUPPORT
-        HARDWARE_SERIAL_PROTOCOLPGM("J16"); // J16 stop print
-        HARDWARE_SERIAL_ENTER();
+        // J16 is sent when the request comes in and again when the print has stopped
+        if (entered)
+        {
+          HARDWARE_SERIAL_PROTOCOLPGM("J16"); // J16 stop print
+          HARDWARE_SERIAL_ENTER();
+        }
         if ((!card.isPrinting()) && (!planner.movesplanned()))
         {
+          if (!entered)
+          {
+            HARDWARE_SERIAL_PROTOCOLPGM("J16");
+            HARDWARE_SERIAL_ENTER();
+          }
           queue.clear();
           TFTstate = ANYCUBIC_TFT_STATE_IDLE;
           #ifdef ANYCUBIC_TFT_DEBUG
@@ -1338,6 +1409,44 @@ void AnycubicTouchscreenClass::FilamentRunout()
 
 static boolean TFTcomment_mode = false;
 
+// Progress of reading the number after the first 'A' of a line
+enum TFTCommandState : uint8_t { TFTCMD_NONE, TFTCMD_SIGN, TFTCMD_POSITIVE, TFTCMD_NEGATIVE };
+
+void AnycubicTouchscreenClass::ScanCommandChar(const char c)
+{
+  // Note where each letter first appears, as strchr would find it
+  const uint8_t i = c - 'A';
+  if (i < COUNT(TFTcodepos) && !TFTcodepos[i])
+  {
+    TFTcodepos[i] = serial3_count + 1;
+    if (c == 'A')
+    {
+      TFTcommand = 0;
+      TFTcommandstate = TFTCMD_SIGN;
+      return;
+    }
+  }
+
+  // Read the number after 'A' as (int)strtod would read a plain decimal
+  switch (TFTcommandstate)
+  {
+    case TFTCMD_SIGN:
+      if (c == ' ' || c == '\t') return;
+      TFTcommandstate = (c == '-') ? TFTCMD_NEGATIVE : TFTCMD_POSITIVE;
+      if (c == '-' || c == '+') return;
+      // fall through
+    case TFTCMD_POSITIVE:
+    case TFTCMD_NEGATIVE:
+      if (!NUMERIC(c))
+        TFTcommandstate = TFTCMD_NONE;
+      else if (WITHIN(TFTcommand, -999, 999)) // Longer numbers are never a command
+        TFTcommand = TFTcommand * 10 + (TFTcommandstate == TFTCMD_NEGATIVE ? '0' - c : c - '0');
+      return;
+    default:
+      return;
+  }
+}
+
 void AnycubicTouchscreenClass::GetCommandFromTFT()
 {
   char *starpos = NULL;
@@ -1401,10 +1510,9 @@ void AnycubicTouchscreenClass::GetCommandFromTFT()
         // -------- FINISH ERROR CORRECTION ----------
         */
       
-        if((strchr(TFTcmdbuffer[TFTbufindw], 'A') != NULL))
+        if(CodeSeen('A'))
         {
-          TFTstrchr_pointer = strchr(TFTcmdbuffer[TFTbufindw], 'A');
-          switch((int)((strtod(&TFTcmdbuffer[TFTbufindw][TFTstrchr_pointer - TFTcmdbuffer[TFTbufindw] + 1], NULL))))
+          switch(TFTcommand)
           {
             case 0: //A0 GET HOTEND TEMP
               HARDWARE_SERIAL_PROTOCOLPGM("A0V ");
@@ -2189,9 +2297,19 @@ void AnycubicTouchscreenClass::GetCommandFromTFT()
       TFTbuflen += 1;
     }
     serial3_count = 0; //clear buffer
+    ZERO(TFTcodepos);
+    TFTcommandstate = TFTCMD_NONE;
+    #if ENABLED(ANYCUBIC_TFT_TX_QUEUE)
+      // Leave the next command waiting until its reply will fit
+      if (!HardwareSerial.tx_ready(TFT_TX_REPLY_MAX)) break;
+    #endif
     } else {
       if(serial3_char == ';') TFTcomment_mode = true;
-      if(!TFTcomment_mode) TFTcmdbuffer[TFTbufindw][serial3_count++] = serial3_char;
+      if(!TFTcomment_mode)
+      {
+        ScanCommandChar(serial3_char);
+        TFTcmdbuffer[TFTbufindw][serial3_count++] = serial3_char;
+      }
     }     
   }
 }
@@ -2239,12 +2357,41 @@ SERIAL_PROTOCOLLN(cvalue);
 
 void AnycubicTouchscreenClass::CommandScan()
 {
-  CheckHeaterError();
-  CheckSDCardChange();
-  StateHandler();
+  // Only look at the state machine when something it depends on has changed.
+  // Heater checks run from TemperatureUpdated() as readings come in.
+  const uint8_t flags = EventFlags();
+  if (flags != LastEventFlags || TFTstate != LastTFTstate || ai3m_pause_state != LastPauseState)
+  {
+    const bool entered = (TFTstate != LastTFTstate);
+    CheckSDCardChange();
+    // Changes made by the handler itself are picked up on the next call
+    LastEventFlags = flags;
+    LastTFTstate = TFTstate;
+    LastPauseState = ai3m_pause_state;
+    StateHandler(entered);
+  }
 
-  if (TFTbuflen < (TFTBUFSIZE - 1))
+  if (TFTbuflen < (TFTBUFSIZE - 1) && HardwareSerial.available())
+  {
+  #if ENABLED(ANYCUBIC_TFT_TX_QUEUE)
+    // Leave new commands waiting until their replies will fit.
+    // Count a held command once, not on every pass it waits.
+    static bool held = false;
+    if (!HardwareSerial.tx_ready(TFT_TX_REPLY_MAX))
+    {
+      if (!held && HardwareSerial.tx_stats.deferred < UINT16_MAX)
+        HardwareSerial.tx_stats.deferred++;
+      held = true;
+    }
+    else
+    {
+      held = false;
+      GetCommandFromTFT();
+    }
+  #else
     GetCommandFromTFT();
+  #endif
+  }
   if (TFTbuflen)
   {
     TFTbuflen = (TFTbuflen - 1);
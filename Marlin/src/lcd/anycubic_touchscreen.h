@@ -47,6 +47,13 @@ char *ftostr32(const float &);
 #define ANYCUBIC_TFT_STATE_SDSTOP_REQ 5
 #define ANYCUBIC_TFT_STATE_SDOUTAGE 99
 
+// Printer state bits that wake up the TFT state handler when they change
+#define ANYCUBIC_TFT_EVENT_SD_INSERTED  _BV(0)
+#define ANYCUBIC_TFT_EVENT_PRINTING     _BV(1)
+#define ANYCUBIC_TFT_EVENT_FILE_OPEN    _BV(2)
+#define ANYCUBIC_TFT_EVENT_MOVES_QUEUED _BV(3)
+#define ANYCUBIC_TFT_EVENT_FILAMENT     _BV(4)
+
 #if DISABLED(KNUTWURST_DGUS2_TFT)
 #define SM_DIR_UP_L           "/.."
 #define SM_DIR_UP_S           ".."
@@ -92,6 +99,8 @@ char *ftostr32(const float &);
 #define SM_EN_FILSENS_S       "<ENSEN>"
 #define SM_EXIT_L             "<Exit>"
 #define SM_EXIT_S             "<EXIT>"
+#define SM_UNDERRUN_L         "<Underruns: XXX>"
+#define SM_UNDERRUN_S         "<UNDRUN>"
 
 #define SM_BACK_L             "<End Mesh Leveling>"
 #define SM_BACK_S             "<BACK>"
@@ -167,6 +176,8 @@ char *ftostr32(const float &);
 #define SM_EN_FILSENS_S       "<ENABL~1.GCO"
 #define SM_EXIT_L             "<Exit>              .gcode"
 #define SM_EXIT_S             "<EXIT_~1.GCO"
+#define SM_UNDERRUN_L         "<Underruns: XXX>    .gcode"
+#define SM_UNDERRUN_S         "<UNDRUN1.GCO"
 
 #define SM_BACK_L             "<End Mesh Leveling> .gcode"
 #define SM_BACK_S             "<BACK_~1.GCO"
@@ -215,6 +226,7 @@ public:
   void HeatingDone();
   void HeatingStart();
   void FilamentRunout();
+  void TemperatureUpdated();
   void KillTFT();
   char TFTstate = ANYCUBIC_TFT_STATE_IDLE;
 
@@ -238,6 +250,9 @@ private:
   char serial3_char;
   int serial3_count = 0;
   char *TFTstrchr_pointer;
+  uint8_t TFTcodepos[26];     // 1 + offset of the first 'A'-'Z' in the line being received, 0 if not seen
+  int16_t TFTcommand = 0;     // Number after the first 'A'
+  uint8_t TFTcommandstate = 0;
   char FlagResumFromOutage = 0;
   uint16_t filenumber = 0;
   unsigned long starttime = 0;
@@ -245,6 +260,9 @@ private:
   uint8_t tmp_extruder = 0;
   char LastSDstatus = 0;
   uint16_t HeaterCheckCount = 0;
+  uint8_t LastEventFlags = 0xFF;
+  char LastTFTstate = ANYCUBIC_TFT_STATE_IDLE;
+  uint8_t LastPauseState = 0;
   bool IsParked = false;
   int currentFlowRate = 0;
 
@@ -267,7 +285,9 @@ private:
   void StartPrint();
   void PausePrint();
   void StopPrint();
-  void StateHandler();
+  uint8_t EventFlags();
+  void StateHandler(const bool entered);
+  void ScanCommandChar(const char c);
   void GetCommandFromTFT();
   void CheckSDCardChange();
   void CheckHeaterError();
@@ -868,8 +868,10 @@ namespace ExtUI {
       void setMeshPoint(const xy_uint8_t &pos, const float zoff) {
         if (WITHIN(pos.x, 0, GRID_MAX_POINTS_X) && WITHIN(pos.y, 0, GRID_MAX_POINTS_Y)) {
           Z_VALUES(pos.x, pos.y) = zoff;
-          #if ENABLED(ABL_BILINEAR_SUBDIVISION)
-            bed_level_virt_interpolate();
+          #if ENABLED(AUTO_BED_LEVELING_BILINEAR) && ANY(ABL_BILINEAR_SUBDIVISION, ABL_BILINEAR_CELL_TABLE, LEVELED_SEGMENT_ADAPTIVE)
+            refresh_bed_level();
+          #elif BOTH(MESH_BED_LEVELING, LEVELED_SEGMENT_ADAPTIVE)
+            mbl.refresh_segment_length();
           #endif
         }
       }
@@ -201,6 +201,11 @@
 #if ENABLED(MESH_EDIT_MENU)
 
   inline void refresh_planner() {
+    #if ENABLED(AUTO_BED_LEVELING_BILINEAR) && ANY(ABL_BILINEAR_SUBDIVISION, ABL_BILINEAR_CELL_TABLE, LEVELED_SEGMENT_ADAPTIVE)
+      refresh_bed_level();
+    #elif BOTH(MESH_BED_LEVELING, LEVELED_SEGMENT_ADAPTIVE)
+      mbl.refresh_segment_length();
+    #endif
     set_current_from_steppers_for_axis(ALL_AXES);
     sync_plan_position();
   }
@@ -0,0 +1,186 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * fixed_point.h - Helpers for the PLANNER_FIXED_POINT kernels
+ *
+ * Q24.8 values carry 8 fraction bits. A normalized reciprocal is a 32-bit
+ * mantissa and a shift, so that small and large divisors keep the same
+ * relative precision. The kernels here get by with integer multiply, shift
+ * and compare, and float multiply and compare, so they don't need the
+ * soft-float division and square root of MCUs without an FPU.
+ *
+ * buildroot/share/scripts/fixed_point_test.py checks each kernel here
+ * against the float planner math on the host.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+// Integer square root, rounded down
+inline uint16_t fp_sqrt(uint32_t v) {
+  uint32_t root = 0, bit = 1UL << 30;
+  while (bit > v) bit >>= 2;
+  while (bit) {
+    if (v >= root + bit) {
+      v -= root + bit;
+      root = (root >> 1) + bit;
+    }
+    else
+      root >>= 1;
+    bit >>= 2;
+  }
+  return uint16_t(root);
+}
+
+// Integer square root of a float from 0 to 65535^2, rounded up.
+// Rounding the argument up first gives the same result.
+inline uint32_t fp_sqrt_ceil(const float v) {
+  uint32_t n = v;
+  if (n < v) n++;
+  const uint32_t root = fp_sqrt(n);
+  return root * root < n ? root + 1 : root;
+}
+
+/**
+ * Square root of a non-negative float, from the integer square root of its
+ * mantissa. The result has 16 significant bits, rounded to nearest, so it's
+ * within 16 ppm. Denormals count as zero. Assumes IEEE 754 single precision.
+ */
+inline float fp_sqrtf(const float v) {
+  uint32_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+  const uint8_t biased = bits >> 23;
+  if (!biased) return 0;
+
+  // v = m * 2^k, with m as 1.23 moved up to the top of 32 bits. Make k even.
+  uint32_t m = ((bits & 0x7FFFFFUL) | 0x800000UL) << 8;
+  int16_t k = int16_t(biased) - 127 - 31;
+  if (k & 1) { m >>= 1; k++; }
+
+  // sqrt(v) = sqrt(m) * 2^(k/2), and sqrt(m) is 16 bits
+  uint32_t root = fp_sqrt(m);
+  if (m - root * root > root) root++;
+
+  // Back to a float with root << 8 as the 24-bit mantissa
+  int16_t e = k / 2 + 15 + 127;
+  if (root >> 16) { root >>= 1; e++; }
+  bits = (uint32_t(e) << 23) | ((root << 8) & 0x7FFFFFUL);
+  float r;
+  memcpy(&r, &bits, sizeof(r));
+  return r;
+}
+
+/**
+ * The lowest of 'limit' and max[i] / |unit[i]| over 'axes' components, given
+ * inverse[i] = 1 / max[i]. The largest |unit[i]| * inverse[i] picks the axis,
+ * so it's a multiply per axis and one division at most. A zero max (infinite
+ * inverse) gives zero, like the division.
+ */
+template<typename U, typename I>
+inline float fp_limit_by_axes(const float limit, const U &unit, const I &inverse, const uint8_t axes) {
+  float worst = 0;
+  for (uint8_t i = 0; i < axes; i++) if (unit[i]) {
+    const float w = (unit[i] < 0 ? -unit[i] : unit[i]) * inverse[i];
+    if (w > worst) worst = w;
+  }
+  return limit * worst > 1 ? 1 / worst : limit;
+}
+
+// Bit length of v, so that 2^(n-1) <= v < 2^n
+inline uint8_t fp_bits(uint32_t v) {
+  uint8_t n = 0;
+  while (v) { v >>= 1; n++; }
+  return n;
+}
+
+// Multiply by a normalized reciprocal, rounding down or up
+inline uint32_t fp_mul_inv(const uint32_t v, const uint32_t mant, const uint8_t shift) {
+  return uint32_t((uint64_t(v) * mant) >> shift);
+}
+inline uint32_t fp_mul_inv_ceil(const uint32_t v, const uint32_t mant, const uint8_t shift) {
+  return uint32_t((uint64_t(v) * mant + (uint64_t(1) << shift) - 1) >> shift);
+}
+
+// Multiply by a Q24.8 value, rounding down
+inline uint32_t fp_mul_q8(const uint32_t v, const uint32_t q) { return uint32_t((uint64_t(v) * q) >> 8); }
+
+// Normalized reciprocal of 2 * accel, so that v / (2 * accel) = fp_mul_inv(v, mant, shift)
+inline uint32_t fp_inverse_2x(const uint32_t accel, uint8_t &shift) {
+  // 2^(s-1) <= accel < 2^s, so 2^(31+s) / (2 * accel) lies in (2^30, 2^31]
+  const uint8_t s = fp_bits(accel);
+  shift = 31 + s;
+  return uint32_t(float(1UL << s) / (2.0f * accel) * 2147483648.0f);
+}
+
+typedef struct {
+  uint32_t accelerate_steps, // Steps spent accelerating
+           plateau_steps,    // Steps at the cruise rate
+           cruise_rate;      // Highest rate reached (only if asked for)
+} fp_trapezoid_t;
+
+/**
+ * The step counts of a trapezoid with rates up to 65535 steps/s, so their
+ * squares fit in 32 bits. 'inverse' and 'shift' are from fp_inverse_2x(accel).
+ * Set 'cruise' to also get the rate reached when there's no room to cruise,
+ * which costs a square root.
+ */
+inline fp_trapezoid_t fp_trapezoid(const uint32_t step_event_count, const uint32_t initial_rate, const uint32_t nominal_rate, const uint32_t final_rate,
+                                   const uint32_t accel, const uint32_t inverse, const uint8_t shift, const bool cruise
+) {
+  const uint32_t nominal_sq = nominal_rate * nominal_rate,
+                 initial_sq = initial_rate * initial_rate,
+                 final_sq = final_rate * final_rate;
+
+  fp_trapezoid_t t;
+  t.cruise_rate = nominal_rate;
+
+  // Steps required for acceleration, deceleration to/from nominal rate: (v1^2 - v0^2) / (2 * accel)
+  t.accelerate_steps = nominal_sq > initial_sq ? fp_mul_inv_ceil(nominal_sq - initial_sq, inverse, shift) : 0;
+  const uint32_t decelerate_steps = nominal_sq > final_sq ? fp_mul_inv(nominal_sq - final_sq, inverse, shift) : 0;
+  // Steps between acceleration and deceleration, if any
+  const int32_t plateau_steps = step_event_count - t.accelerate_steps - decelerate_steps;
+
+  if (plateau_steps >= 0) {
+    t.plateau_steps = plateau_steps;
+    return t;
+  }
+
+  // No room to reach the nominal rate. Accelerate to the point where braking
+  // reaches final_rate at the end of the block: (d + (vf^2 - vi^2) / (2 * accel)) / 2
+  int32_t twice_accelerate = step_event_count;
+  if (final_sq > initial_sq)
+    twice_accelerate += fp_mul_inv_ceil(final_sq - initial_sq, inverse, shift);
+  else
+    twice_accelerate -= fp_mul_inv(initial_sq - final_sq, inverse, shift);
+  t.accelerate_steps = twice_accelerate > 0 ? (uint32_t(twice_accelerate + 1) >> 1) : 0;
+  if (t.accelerate_steps > step_event_count) t.accelerate_steps = step_event_count;
+  t.plateau_steps = 0;
+
+  if (cruise) {
+    // The rate reached at the top: sqrt(vi^2 + 2 * accel * d)
+    const uint64_t top_sq = initial_sq + uint64_t(accel) * 2 * t.accelerate_steps;
+    t.cruise_rate = fp_sqrt(top_sq > UINT32_MAX ? UINT32_MAX : uint32_t(top_sq));
+  }
+  return t;
+}
@@ -63,6 +63,10 @@
   #include "../HAL/shared/eeprom_api.h"
 #endif
 
+#if ENABLED(EEPROM_ASYNC_SAVE) && defined(__AVR__)
+  #include <avr/eeprom.h>
+#endif
+
 #include "probe.h"
 
 #if HAS_LEVELING
@@ -442,6 +446,8 @@ void MarlinSettings::postprocess() {
 
   #if ENABLED(AUTO_BED_LEVELING_BILINEAR)
     refresh_bed_level();
+  #elif BOTH(MESH_BED_LEVELING, LEVELED_SEGMENT_ADAPTIVE)
+    mbl.refresh_segment_length();
   #endif
 
   #if HAS_MOTOR_CURRENT_PWM
@@ -520,7 +526,11 @@ void MarlinSettings::postprocess() {
                                   int eeprom_index = EEPROM_OFFSET
   #define EEPROM_FINISH()         persistentStore.access_finish()
   #define EEPROM_SKIP(VAR)        (eeprom_index += sizeof(VAR))
-  #define EEPROM_WRITE(VAR)       do{ persistentStore.write_data(eeprom_index, (uint8_t*)&VAR, sizeof(VAR), &working_crc);              }while(0)
+  #if ENABLED(EEPROM_ASYNC_SAVE)
+    #define EEPROM_WRITE(VAR)     do{ stage_data(eeprom_index, (uint8_t*)&VAR, sizeof(VAR), &working_crc);                               }while(0)
+  #else
+    #define EEPROM_WRITE(VAR)     do{ persistentStore.write_data(eeprom_index, (uint8_t*)&VAR, sizeof(VAR), &working_crc);              }while(0)
+  #endif
   #define EEPROM_READ(VAR)        do{ persistentStore.read_data(eeprom_index, (uint8_t*)&VAR, sizeof(VAR), &working_crc, !validating);  }while(0)
   #define EEPROM_READ_ALWAYS(VAR) do{ persistentStore.read_data(eeprom_index, (uint8_t*)&VAR, sizeof(VAR), &working_crc);               }while(0)
   #define EEPROM_ASSERT(TST,ERR)  do{ if (!(TST)) { SERIAL_ERROR_MSG(ERR); eeprom_error = true; } }while(0)
@@ -550,10 +560,105 @@ void MarlinSettings::postprocess() {
     return false;
   }
 
+  #if ENABLED(EEPROM_ASYNC_SAVE)
+
+    MarlinSettings::dirty_byte_t MarlinSettings::dirty[EEPROM_ASYNC_SAVE_BYTES];
+    uint8_t MarlinSettings::dirty_count, MarlinSettings::dirty_index;
+    bool MarlinSettings::staging, MarlinSettings::dirty_overflow;
+
+    /**
+     * While staging, compare each byte with the EEPROM and queue only
+     * the ones that changed. Otherwise write through as usual.
+     */
+    bool MarlinSettings::stage_data(int &pos, const uint8_t *value, size_t size, uint16_t *crc) {
+      if (!staging) return persistentStore.write_data(pos, value, size, crc);
+      while (size--) {
+        uint8_t stored;
+        persistentStore.read_data(pos, &stored);
+        if (stored != *value) {
+          if (dirty_count < EEPROM_ASYNC_SAVE_BYTES)
+            dirty[dirty_count++] = { uint16_t(pos), *value };
+          else
+            dirty_overflow = true;
+        }
+        crc16(crc, value, 1);
+        pos++;
+        value++;
+      }
+      return false;
+    }
+
+    /**
+     * Write the next queued byte, if the EEPROM is ready for it.
+     *
+     * The checksum is queued after the data it covers, so it acts as the
+     * commit. If power is lost part way the old checksum no longer matches
+     * and the next load rejects the half-written data, as for an
+     * interrupted blocking save.
+     */
+    void MarlinSettings::write_pending() {
+      if (!dirty_count) return;
+
+      #ifdef __AVR__
+        if (!eeprom_is_ready()) return;   // Previous byte is still being programmed
+
+        // Verify the previous byte now that it can be read without waiting
+        bool failed = false;
+        if (dirty_index) {
+          const dirty_byte_t &d = dirty[dirty_index - 1];
+          failed = eeprom_read_byte((uint8_t*)d.pos) != d.value;
+        }
+        if (!failed && dirty_index < dirty_count) {
+          const dirty_byte_t &d = dirty[dirty_index++];
+          eeprom_write_byte((uint8_t*)d.pos, d.value);  // Returns once programming has started
+          return;
+        }
+        if (failed) SERIAL_ECHO_MSG(STR_ERR_EEPROM_WRITE);
+      #else
+        bool failed = !persistentStore.access_start();
+        if (!failed) {
+          const dirty_byte_t &d = dirty[dirty_index++];
+          failed = persistentStore.write_data(d.pos, &d.value);
+          failed |= !persistentStore.access_finish();
+        }
+        if (!failed && dirty_index < dirty_count) return;
+      #endif
+
+      dirty_count = dirty_index = 0;
+      eeprom_error = failed;
+      save_finished();
+    }
+
+    void MarlinSettings::flush_pending() {
+      while (dirty_count) write_pending();
+    }
+
+  #endif // EEPROM_ASYNC_SAVE
+
   /**
    * M500 - Store Configuration
    */
   bool MarlinSettings::save() {
+    #if ENABLED(EEPROM_ASYNC_SAVE)
+      // Queue the changed bytes for write_pending(). If too many changed
+      // to fit in the queue, or staging failed, drop what was queued and
+      // fall back to a blocking save.
+      dirty_count = dirty_index = 0;
+      dirty_overflow = false;
+      staging = true;
+      const bool staged = _save();
+      staging = false;
+      if (staged) {
+        if (!dirty_count) save_finished();  // Nothing changed. Otherwise finished by write_pending()
+        return true;
+      }
+      dirty_count = 0;
+      dirty_overflow = false;
+    #endif
+    return _save();
+  }
+
+  bool MarlinSettings::_save() {
     float dummyf = 0;
     char ver[4] = "ERR";
 
@@ -564,7 +669,11 @@ void MarlinSettings::postprocess() {
     eeprom_error = false;
 
     // Write or Skip version. (Flash doesn't allow rewrite without erase.)
-    TERN(FLASH_EEPROM_EMULATION, EEPROM_SKIP, EEPROM_WRITE)(ver);
+    #if ENABLED(EEPROM_ASYNC_SAVE)
+      if (staging) EEPROM_SKIP(ver);  // The checksum, queued last, guards the data instead
+      else
+    #endif
+        TERN(FLASH_EEPROM_EMULATION, EEPROM_SKIP, EEPROM_WRITE)(ver);
 
     EEPROM_SKIP(working_crc); // Skip the checksum slot
 
@@ -1357,13 +1466,30 @@ void MarlinSettings::postprocess() {
       EEPROM_WRITE(final_crc);
 
       // Report storage size
-      DEBUG_ECHO_START();
-      DEBUG_ECHOLNPAIR("Settings Stored (", eeprom_size, " bytes; crc ", (uint32_t)final_crc, ")");
+      #if ENABLED(EEPROM_ASYNC_SAVE)
+        if (staging && (dirty_overflow || eeprom_size != datasize()))
+          eeprom_error = true;  // save() falls back to a blocking save, which reports instead
+        else
+      #endif
+        {
+          DEBUG_ECHO_START();
+          DEBUG_ECHOLNPAIR("Settings Stored (", eeprom_size, " bytes; crc ", (uint32_t)final_crc, ")");
 
-      eeprom_error |= size_error(eeprom_size);
+          eeprom_error |= size_error(eeprom_size);
+        }
     }
     EEPROM_FINISH();
 
+    #if ENABLED(EEPROM_ASYNC_SAVE)
+      if (staging) return !eeprom_error;  // Finished by save()
+    #endif
+
+    save_finished();
+
+    return !eeprom_error;
+  }
+
+  void MarlinSettings::save_finished() {
     //
     // UBL Mesh
     //
@@ -1375,8 +1501,6 @@ void MarlinSettings::postprocess() {
     #if ENABLED(EXTENSIBLE_UI)
       ExtUI::onConfigurationStoreWritten(!eeprom_error);
     #endif
-
-    return !eeprom_error;
   }
 
   /**
@@ -1385,6 +1509,10 @@ void MarlinSettings::postprocess() {
   bool MarlinSettings::_load() {
     uint16_t working_crc = 0;
 
+    #if ENABLED(EEPROM_ASYNC_SAVE)
+      flush_pending();  // Read back what was last saved
+    #endif
+
     EEPROM_START();
 
     char stored_ver[4];
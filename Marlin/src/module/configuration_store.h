@@ -71,6 +71,12 @@ class MarlinSettings {
         if (!loaded && load()) loaded = true;
       }
 
+      #if ENABLED(EEPROM_ASYNC_SAVE)
+        static void write_pending();  // Write the next queued byte. Called from idle().
+        static void flush_pending();  // Write all queued bytes before returning
+        FORCE_INLINE static bool save_pending() { return dirty_count; }
+      #endif
+
       #if ENABLED(AUTO_BED_LEVELING_UBL) // Eventually make these available if any leveling system
                                          // That can store is enabled
         static uint16_t meshes_start_index();
@@ -111,7 +117,17 @@ class MarlinSettings {
       #endif
 
       static bool _load();
+      static bool _save();
+      static void save_finished();
       static bool size_error(const uint16_t size);
+
+      #if ENABLED(EEPROM_ASYNC_SAVE)
+        typedef struct { uint16_t pos; uint8_t value; } dirty_byte_t;
+        static dirty_byte_t dirty[EEPROM_ASYNC_SAVE_BYTES];
+        static uint8_t dirty_count, dirty_index;
+        static bool staging, dirty_overflow;
+        static bool stage_data(int &pos, const uint8_t *value, size_t size, uint16_t *crc);
+      #endif
     #endif
 };
 
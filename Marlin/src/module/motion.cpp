@@ -862,9 +862,16 @@ FORCE_INLINE void segment_idle(millis_t &next_idle_ms) {
       if (UNEAR_ZERO(cartesian_mm)) cartesian_mm = ABS(diff.e);
       if (UNEAR_ZERO(cartesian_mm)) return;
 
-      // The length divided by the segment size
+      #if ENABLED(LEVELED_SEGMENT_ADAPTIVE)
+        // Segments must not exceed the size found from the mesh.
+        // A size of 0 means the mesh is flat enough for a single move.
+        uint16_t segments = segment_size ? CEIL(cartesian_mm / segment_size) : 1;
+      #else
+        // The length divided by the segment size
+        uint16_t segments = cartesian_mm / segment_size;
+      #endif
+
       // At least one segment is required
-      uint16_t segments = cartesian_mm / segment_size;
       NOLESS(segments, 1U);
 
       // The approximate length of each segment
@@ -923,7 +930,11 @@ FORCE_INLINE void segment_idle(millis_t &next_idle_ms) {
           ubl.line_to_destination_cartesian(scaled_fr_mm_s, active_extruder); // UBL's motion routine needs to know about
           return true;                                                        // all moves, including Z-only moves.
         #elif ENABLED(SEGMENT_LEVELED_MOVES)
-          segmented_line_to_destination(scaled_fr_mm_s);
+          segmented_line_to_destination(scaled_fr_mm_s
+            #if ENABLED(LEVELED_SEGMENT_ADAPTIVE)
+              , leveled_segment_length
+            #endif
+          );
           return false; // caller will update current_position
         #else
           /**
@@ -69,6 +69,9 @@
 #include "../lcd/ultralcd.h"
 #include "../core/language.h"
 #include "../gcode/parser.h"
+#if ENABLED(PLANNER_UNDERRUN_STATS)
+  #include "../gcode/queue.h"
+#endif
 
 #include "../MarlinCore.h"
 
@@ -119,7 +122,12 @@ Planner planner;
 /**
  * A ring buffer of moves described in steps
  */
-block_t Planner::block_buffer[BLOCK_BUFFER_SIZE];
+#if ENABLED(BLOCK_BUFFER_AUTO_SIZE)
+  block_t *Planner::block_buffer;
+  uint8_t Planner::block_buffer_size = BLOCK_BUFFER_SIZE;
+#else
+  block_t Planner::block_buffer[BLOCK_BUFFER_SIZE];
+#endif
 volatile uint8_t Planner::block_buffer_head,    // Index of the next block to be pushed
                  Planner::block_buffer_nonbusy, // Index of the first non-busy block
                  Planner::block_buffer_planned, // Index of the optimally planned block
@@ -129,7 +137,27 @@ uint8_t Planner::delay_before_delivering;       // This counter delays delivery
 
 planner_settings_t Planner::settings;           // Initialized by settings.load()
 
+#if ENABLED(PLANNER_LOOKAHEAD_STATS)
+  lookahead_stats_t Planner::lookahead_stats;
+#endif
+#if ENABLED(PLANNER_UNDERRUN_STATS)
+  underrun_stats_t Planner::underrun_stats = { 0, 0, 0, 0, 0xFF };
+  bool Planner::was_moving, Planner::in_underrun;
+  millis_t Planner::underrun_start_ms;
+  uint32_t Planner::underrun_line;
+#endif
+#if HAS_GCODE_WAIT
+  bool Planner::gcode_wait;
+  uint8_t Planner::gcode_waits;
+#endif
+#if ENABLED(PLANNER_FIXED_POINT_CHECK)
+  fixed_point_error_t Planner::fixed_point_error;
+#endif
+
 uint32_t Planner::max_acceleration_steps_per_s2[XYZE_N]; // (steps/s^2) Derived from mm_per_s2
+#if ENABLED(PLANNER_FIXED_POINT) && DISABLED(CLASSIC_JERK)
+  float Planner::max_acceleration_inverse[XYZE]; // (s^2/mm) Derived from mm_per_s2
+#endif
 
 float Planner::steps_to_mm[XYZE_N];           // (mm) Millimeters per step
 
@@ -252,6 +280,32 @@ void Planner::init() {
   delay_before_delivering = 0;
 }
 
+#if ENABLED(BLOCK_BUFFER_AUTO_SIZE)
+
+  /**
+   * Size the block buffer from the RAM left over after static allocation.
+   * Call once from setup(), before anything is queued. Start at the largest
+   * size that leaves BLOCK_BUFFER_RAM_RESERVE bytes free and halve until
+   * the allocation succeeds, but never below BLOCK_BUFFER_SIZE. Halt if
+   * even that much can't be had, as the planner can't run without it.
+   */
+  void Planner::allocate_block_buffer() {
+    const int32_t spare = int32_t(freeMemory()) - (BLOCK_BUFFER_RAM_RESERVE);
+    uint8_t size = BLOCK_BUFFER_SIZE_MAX;
+    while (size > BLOCK_BUFFER_SIZE && int32_t(size * sizeof(block_t)) > spare) size >>= 1;
+    while (!(block_buffer = (block_t*)calloc(size, sizeof(block_t)))) {
+      if (size == BLOCK_BUFFER_SIZE) {
+        SERIAL_ERROR_MSG("Not enough RAM for BLOCK_BUFFER_SIZE blocks");
+        minkill();
+      }
+      size >>= 1;
+    }
+    block_buffer_size = size;
+    clear_block_buffer();
+  }
+
+#endif
+
 #if ENABLED(S_CURVE_ACCELERATION)
   #ifdef __AVR__
     /**
@@ -743,6 +797,21 @@ block_t* Planner::get_current_block() {
       block_buffer_runtime_us -= block->segment_time_us; // We can't be sure how long an active block will take, so don't count it.
     #endif
 
+    #if ENABLED(PLANNER_UNDERRUN_STATS)
+      if (in_underrun) {
+        in_underrun = false;
+        const millis_t ms = millis() - underrun_start_ms;
+        underrun_stats.total_ms += ms;
+        if (ms > underrun_stats.longest_ms) {
+          underrun_stats.longest_ms = ms;
+          underrun_stats.longest_line = underrun_line;
+        }
+      }
+      else if (was_moving && printingIsActive())
+        NOMORE(underrun_stats.low_water, nr_moves);
+      was_moving = true;
+    #endif
+
     // As this block is busy, advance the nonbusy block pointer
     block_buffer_nonbusy = next_block_index(block_buffer_tail);
 
@@ -759,12 +828,49 @@ block_t* Planner::get_current_block() {
     clear_block_buffer_runtime(); // paranoia. Buffer is empty now - so reset accumulated time to zero.
   #endif
 
+  // Only count a buffer that ran dry while printing, not the wait for the first move
+  #if ENABLED(PLANNER_UNDERRUN_STATS)
+    if (was_moving) {
+      was_moving = false;
+      if (printingIsActive() && !gcode_wait) {
+        in_underrun = true;
+        underrun_start_ms = millis();
+        underrun_line = queue.current_line;
+        underrun_stats.count++;
+      }
+    }
+  #endif
+
   return nullptr;
 }
 
+#if ENABLED(PLANNER_FIXED_POINT)
+
+  /**
+   * The step rate for a squared speed: the square root of speed_sqr times the
+   * block's (steps/mm)^2, rounded up. Up to 65535 steps/s that's an integer
+   * square root, so the entry and exit rates need no float division or square root.
+   */
+  uint32_t Planner::rate_for_speed_sqr(const block_t* const block, const float &speed_sqr) {
+    constexpr float rate_sqr_max = float(UINT16_MAX) * float(UINT16_MAX);
+    const float rate_sqr = speed_sqr * block->steps_per_mm_sqr;
+    const uint32_t rate = rate_sqr < rate_sqr_max ? fp_sqrt_ceil(rate_sqr) : uint32_t(CEIL(SQRT(rate_sqr)));
+
+    #if ENABLED(PLANNER_FIXED_POINT_CHECK)
+      // The float path's factor of the nominal rate
+      const uint32_t float_rate = CEIL(block->nominal_rate * (SQRT(speed_sqr) * (1.0f / SQRT(block->nominal_speed_sqr))));
+      NOLESS(fixed_point_error.rate, uint32_t(ABS(int32_t(rate - float_rate))));
+    #endif
+
+    return rate;
+  }
+
+#endif
+
 /**
  * Calculate trapezoid parameters, multiplying the entry- and exit-speeds
- * by the provided factors.
+ * by the provided factors. With PLANNER_FIXED_POINT the entry and exit
+ * step rates are given instead.
  **
  * ############ VERY IMPORTANT ############
  * NOTE that the PRECONDITION to call this function is that the block is
@@ -772,15 +878,93 @@ block_t* Planner::get_current_block() {
  * is not and will not use the block while we modify it, so it is safe to
  * alter its values.
  */
+#if ENABLED(PLANNER_FIXED_POINT)
+void Planner::calculate_trapezoid_for_rates(block_t* const block, uint32_t initial_rate, uint32_t final_rate) {
+#else
 void Planner::calculate_trapezoid_for_block(block_t* const block, const float &entry_factor, const float &exit_factor) {
-
   uint32_t initial_rate = CEIL(block->nominal_rate * entry_factor),
            final_rate = CEIL(block->nominal_rate * exit_factor); // (steps per second)
+#endif
 
   // Limit minimal step rate (Otherwise the timer will overflow.)
   NOLESS(initial_rate, uint32_t(MINIMAL_STEP_RATE));
   NOLESS(final_rate, uint32_t(MINIMAL_STEP_RATE));
 
+  #if ENABLED(PLANNER_FIXED_POINT)
+    // The squared rates have to fit in 32 bits
+    if (_MAX(block->nominal_rate, initial_rate, final_rate) <= UINT16_MAX && block->acceleration_inverse) {
+      #if ENABLED(PLANNER_FIXED_POINT_CHECK)
+        calculate_trapezoid_float(block, initial_rate, final_rate);
+        const uint32_t float_until = block->accelerate_until, float_after = block->decelerate_after;
+        #if ENABLED(S_CURVE_ACCELERATION)
+          const uint32_t float_cruise = block->cruise_rate,
+                         float_accel_time = block->acceleration_time,
+                         float_decel_time = block->deceleration_time;
+        #endif
+      #endif
+
+      calculate_trapezoid_fixed(block, initial_rate, final_rate);
+
+      #if ENABLED(PLANNER_FIXED_POINT_CHECK)
+        // The float path can wrap when the exit rate is over the nominal or
+        // cruise rate. Those blocks have no usable reference, so skip them.
+        if (float_after <= block->step_event_count) {
+          #define FP_ERROR(A,B) uint32_t(ABS(int32_t((A) - (B))))
+          fixed_point_error.checks++;
+          NOLESS(fixed_point_error.steps, _MAX(FP_ERROR(block->accelerate_until, float_until), FP_ERROR(block->decelerate_after, float_after)));
+          #if ENABLED(S_CURVE_ACCELERATION)
+            NOLESS(fixed_point_error.rate, FP_ERROR(block->cruise_rate, float_cruise));
+            // A phase time only matters when the phase has steps
+            if (float_until) NOLESS(fixed_point_error.ticks, FP_ERROR(block->acceleration_time, float_accel_time));
+            if (float_after < block->step_event_count) NOLESS(fixed_point_error.ticks, FP_ERROR(block->deceleration_time, float_decel_time));
+          #endif
+          #undef FP_ERROR
+        }
+      #endif
+      return;
+    }
+  #endif
+
+  calculate_trapezoid_float(block, initial_rate, final_rate);
+}
+
+#if ENABLED(PLANNER_FIXED_POINT)
+
+  /**
+   * The trapezoid calculation in integer math. Rates and their squares are
+   * 32-bit integers and distances come from multiplying by the block's
+   * reciprocal of 2*accel, so there's no division or float square root here.
+   */
+  void Planner::calculate_trapezoid_fixed(block_t* const block, const uint32_t initial_rate, const uint32_t final_rate) {
+    const fp_trapezoid_t t = fp_trapezoid(block->step_event_count, initial_rate, block->nominal_rate, final_rate,
+                                          block->acceleration_steps_per_s2, block->acceleration_inverse, block->acceleration_inverse_shift,
+                                          ENABLED(S_CURVE_ACCELERATION));
+
+    #if ENABLED(S_CURVE_ACCELERATION)
+      const uint32_t cruise_rate = t.cruise_rate;
+
+      // Jerk controlled speed requires to express speed versus time, NOT steps
+      const uint32_t acceleration_time = cruise_rate > initial_rate ? fp_mul_q8(cruise_rate - initial_rate, block->rate_change_ticks) : 0,
+                     deceleration_time = cruise_rate > final_rate ? fp_mul_q8(cruise_rate - final_rate, block->rate_change_ticks) : 0;
+
+      block->acceleration_time = acceleration_time;
+      block->deceleration_time = deceleration_time;
+      block->acceleration_time_inverse = get_period_inverse(acceleration_time);
+      block->deceleration_time_inverse = get_period_inverse(deceleration_time);
+      block->cruise_rate = cruise_rate;
+    #endif
+
+    block->accelerate_until = t.accelerate_steps;
+    block->decelerate_after = t.accelerate_steps + t.plateau_steps;
+    block->initial_rate = initial_rate;
+    block->final_rate = final_rate;
+  }
+
+#endif // PLANNER_FIXED_POINT
+
+// The float trapezoid calculation, for blocks the fixed-point path can't handle
+void Planner::calculate_trapezoid_float(block_t* const block, const uint32_t initial_rate, const uint32_t final_rate) {
+
   #if ENABLED(S_CURVE_ACCELERATION)
     uint32_t cruise_rate = initial_rate;
   #endif
@@ -899,7 +1083,8 @@ void Planner::calculate_trapezoid_for_block(block_t* const block, const float &e
 */
 
 // The kernel called by recalculate() when scanning the plan from last to first entry.
-void Planner::reverse_pass_kernel(block_t* const current, const block_t * const next) {
+// Returns false if the entry speed of the current block was left unchanged.
+bool Planner::reverse_pass_kernel(block_t* const current, const block_t * const next) {
   if (current) {
     // If entry speed is already at the maximum entry speed, and there was no change of speed
     // in the next block, there is no need to recheck. Block is cruising and there is no need to
@@ -940,17 +1125,28 @@ void Planner::reverse_pass_kernel(block_t* const current, const block_t * const
           // Block is not BUSY so this is ahead of the Stepper ISR:
           // Just Set the new entry speed.
           current->entry_speed_sqr = new_entry_speed_sqr;
+          return true;
         }
       }
     }
   }
+  return false;
 }
 
 /**
  * recalculate() needs to go over the current plan twice.
  * Once in reverse and once forward. This implements the reverse pass.
+ *
+ * Each block's reverse-planned entry speed depends only on the entry speed
+ * of the block after it. So once a block comes through unchanged, no block
+ * before it can change either and the pass stops there. This keeps the work
+ * per appended block bounded by the length of the deceleration ramp instead
+ * of the length of the buffer.
+ *
+ * Returns the index of the block where the pass stopped. Its entry speed
+ * is unchanged, so the forward pass and trapezoids can start from it.
  */
-void Planner::reverse_pass() {
+uint8_t Planner::reverse_pass() {
   // Initialize block index to the last block in the planner buffer.
   uint8_t block_index = prev_block_index(block_buffer_head);
 
@@ -961,7 +1157,7 @@ void Planner::reverse_pass() {
   // If there was a race condition and block_buffer_planned was incremented
   //  or was pointing at the head (queue empty) break loop now and avoid
   //  planning already consumed blocks
-  if (planned_block_index == block_buffer_head) return;
+  if (planned_block_index == block_buffer_head) return planned_block_index;
 
   // Reverse Pass: Coarsely maximize all possible deceleration curves back-planning from the last
   // block in buffer. Cease planning when the last optimal planned or tail pointer is reached.
@@ -974,7 +1170,9 @@ void Planner::reverse_pass() {
 
     // Only consider non sync blocks
     if (!TEST(current->flag, BLOCK_BIT_SYNC_POSITION)) {
-      reverse_pass_kernel(current, next);
+      // The newest block always has a changed exit, so it's never a stopping point.
+      // Past that, an unchanged entry speed means everything before it is settled.
+      if (!reverse_pass_kernel(current, next) && next) return block_index;
       next = current;
     }
 
@@ -987,12 +1185,14 @@ void Planner::reverse_pass() {
     while (planned_block_index != block_buffer_planned) {
 
       // If we reached the busy block or an already processed block, break the loop now
-      if (block_index == planned_block_index) return;
+      if (block_index == planned_block_index) return planned_block_index;
 
       // Advance the pointer, following the busy block
       planned_block_index = next_block_index(planned_block_index);
     }
   }
+
+  return planned_block_index;
 }
 
 // The kernel called by recalculate() when scanning the plan from first to last entry.
@@ -1049,16 +1249,15 @@ void Planner::forward_pass_kernel(const block_t* const previous, block_t* const
  * recalculate() needs to go over the current plan twice.
  * Once in reverse and once forward. This implements the forward pass.
  */
-void Planner::forward_pass() {
+void Planner::forward_pass(uint8_t block_index) {
 
-  // Forward Pass: Forward plan the acceleration curve from the planned pointer onward.
+  // Forward Pass: Forward plan the acceleration curve from where the reverse pass stopped.
   // Also scans for optimal plan breakpoints and appropriately updates the planned pointer.
 
-  // Begin at buffer planned pointer. Note that block_buffer_planned can be modified
-  //  by the stepper ISR,  so read it ONCE. It it guaranteed that block_buffer_planned
-  //  will never lead head, so the loop is safe to execute. Also note that the forward
-  //  pass will never modify the values at the tail.
-  uint8_t block_index = block_buffer_planned;
+  // Begin at the block where the reverse pass stopped. Nothing before it has changed, so
+  //  there's nothing to refine there. The reverse pass never goes back past the planned
+  //  pointer, which never leads head, so the loop is safe to execute. Also note that the
+  //  forward pass will never modify the values at the tail.
 
   block_t *block;
   const block_t * previous = nullptr;
@@ -1084,14 +1283,20 @@ void Planner::forward_pass() {
 }
 
 /**
- * Recalculate the trapezoid speed profiles for all blocks in the plan
+ * Recalculate the trapezoid speed profiles for the blocks in the plan
  * according to the entry_factor for each junction. Must be called by
- * recalculate() after updating the blocks.
+ * recalculate() after updating the blocks. Blocks before 'block_index'
+ * have unchanged entry and exit speeds and are skipped.
  */
-void Planner::recalculate_trapezoids() {
+void Planner::recalculate_trapezoids(uint8_t block_index) {
   // The tail may be changed by the ISR so get a local copy.
-  uint8_t block_index = block_buffer_tail,
-          head_block_index = block_buffer_head;
+  const uint8_t tail = block_buffer_tail;
+  uint8_t head_block_index = block_buffer_head;
+
+  // Start from the block before the first changed one, since its exit speed may have
+  // changed too. If the stepper ISR already consumed it, start from the tail instead.
+  if (block_index != tail) block_index = prev_block_index(block_index);
+  if (BLOCK_MOD(block_index - tail) >= BLOCK_MOD(head_block_index - tail)) block_index = tail;
   // Since there could be a sync block in the head of the queue, and the
   // next loop must not recalculate the head block (as it needs to be
   // specially handled), scan backwards to the first non-SYNC block.
@@ -1112,14 +1317,23 @@ void Planner::recalculate_trapezoids() {
 
   // Go from the tail (currently executed block) to the first block, without including it)
   block_t *block = nullptr, *next = nullptr;
-  float current_entry_speed = 0.0, next_entry_speed = 0.0;
+  #if ENABLED(PLANNER_FIXED_POINT)
+    // Carry the squared speeds. Each block turns them into its own step rates.
+    float current_entry_speed_sqr = 0.0, next_entry_speed_sqr = 0.0;
+  #else
+    float current_entry_speed = 0.0, next_entry_speed = 0.0;
+  #endif
   while (block_index != head_block_index) {
 
     next = &block_buffer[block_index];
 
     // Skip sync blocks
     if (!TEST(next->flag, BLOCK_BIT_SYNC_POSITION)) {
-      next_entry_speed = SQRT(next->entry_speed_sqr);
+      #if ENABLED(PLANNER_FIXED_POINT)
+        next_entry_speed_sqr = next->entry_speed_sqr;
+      #else
+        next_entry_speed = SQRT(next->entry_speed_sqr);
+      #endif
 
       if (block) {
         // Recalculate if current block entry or exit junction speed has changed.
@@ -1136,12 +1350,20 @@ void Planner::recalculate_trapezoids() {
           if (!stepper.is_block_busy(block)) {
             // Block is not BUSY, we won the race against the Stepper ISR:
 
-            // NOTE: Entry and exit factors always > 0 by all previous logic operations.
-            const float current_nominal_speed = SQRT(block->nominal_speed_sqr),
-                        nomr = 1.0f / current_nominal_speed;
-            calculate_trapezoid_for_block(block, current_entry_speed * nomr, next_entry_speed * nomr);
+            #if ENABLED(PLANNER_FIXED_POINT)
+              calculate_trapezoid_for_rates(block, rate_for_speed_sqr(block, current_entry_speed_sqr), rate_for_speed_sqr(block, next_entry_speed_sqr));
+            #else
+              // NOTE: Entry and exit factors always > 0 by all previous logic operations.
+              const float current_nominal_speed = SQRT(block->nominal_speed_sqr),
+                          nomr = 1.0f / current_nominal_speed;
+              calculate_trapezoid_for_block(block, current_entry_speed * nomr, next_entry_speed * nomr);
+            #endif
             #if ENABLED(LIN_ADVANCE)
               if (block->use_advance_lead) {
+                #if ENABLED(PLANNER_FIXED_POINT)
+                  const float current_nominal_speed = SQRT(block->nominal_speed_sqr),
+                              next_entry_speed = SQRT(next_entry_speed_sqr);
+                #endif
                 const float comp = block->e_D_ratio * extruder_advance_K[active_extruder] * settings.axis_steps_per_mm[E_AXIS];
                 block->max_adv_steps = current_nominal_speed * comp;
                 block->final_adv_steps = next_entry_speed * comp;
@@ -1156,7 +1378,11 @@ void Planner::recalculate_trapezoids() {
       }
 
       block = next;
-      current_entry_speed = next_entry_speed;
+      #if ENABLED(PLANNER_FIXED_POINT)
+        current_entry_speed_sqr = next_entry_speed_sqr;
+      #else
+        current_entry_speed = next_entry_speed;
+      #endif
     }
 
     block_index = next_block_index(block_index);
@@ -1176,11 +1402,18 @@ void Planner::recalculate_trapezoids() {
     if (!stepper.is_block_busy(block)) {
       // Block is not BUSY, we won the race against the Stepper ISR:
 
-      const float next_nominal_speed = SQRT(next->nominal_speed_sqr),
-                  nomr = 1.0f / next_nominal_speed;
-      calculate_trapezoid_for_block(next, next_entry_speed * nomr, float(MINIMUM_PLANNER_SPEED) * nomr);
+      #if ENABLED(PLANNER_FIXED_POINT)
+        calculate_trapezoid_for_rates(next, rate_for_speed_sqr(next, next_entry_speed_sqr), rate_for_speed_sqr(next, sq(float(MINIMUM_PLANNER_SPEED))));
+      #else
+        const float next_nominal_speed = SQRT(next->nominal_speed_sqr),
+                    nomr = 1.0f / next_nominal_speed;
+        calculate_trapezoid_for_block(next, next_entry_speed * nomr, float(MINIMUM_PLANNER_SPEED) * nomr);
+      #endif
       #if ENABLED(LIN_ADVANCE)
         if (next->use_advance_lead) {
+          #if ENABLED(PLANNER_FIXED_POINT)
+            const float next_nominal_speed = SQRT(next->nominal_speed_sqr);
+          #endif
           const float comp = next->e_D_ratio * extruder_advance_K[active_extruder] * settings.axis_steps_per_mm[E_AXIS];
           next->max_adv_steps = next_nominal_speed * comp;
           next->final_adv_steps = (MINIMUM_PLANNER_SPEED) * comp;
@@ -1196,15 +1429,74 @@ void Planner::recalculate_trapezoids() {
 
 void Planner::recalculate() {
   // Initialize block index to the last block in the planner buffer.
-  const uint8_t block_index = prev_block_index(block_buffer_head);
+  const uint8_t head = block_buffer_head;
+  uint8_t block_index = prev_block_index(head);
   // If there is just one block, no planning can be done. Avoid it!
   if (block_index != block_buffer_planned) {
-    reverse_pass();
-    forward_pass();
+    block_index = reverse_pass();
+    forward_pass(block_index);
   }
-  recalculate_trapezoids();
+  recalculate_trapezoids(block_index);
+
+  #if ENABLED(PLANNER_LOOKAHEAD_STATS)
+    // Blocks from the stopping point to the head were visited by each pass
+    const uint8_t touched = BLOCK_MOD(head - block_index);
+    lookahead_stats.appends++;
+    lookahead_stats.blocks_touched += touched;
+    NOLESS(lookahead_stats.max_touched, touched);
+  #endif
 }
 
+#if HAS_PLANNER_REPORT
+
+  void Planner::report_stats() {
+    #if ENABLED(PLANNER_LOOKAHEAD_STATS)
+      const lookahead_stats_t stats = lookahead_stats;
+      SERIAL_ECHOPAIR("Look-ahead appends:", stats.appends, " touched:", stats.blocks_touched);
+      if (stats.appends) SERIAL_ECHOPAIR(" avg:", float(stats.blocks_touched) / stats.appends);
+      SERIAL_ECHOLNPAIR(" max:", int(stats.max_touched), " of ", int(BLOCK_BUFFER_LEN));
+    #endif
+    #if ENABLED(PLANNER_UNDERRUN_STATS)
+      const underrun_stats_t under = get_underrun_stats();
+      SERIAL_ECHOPAIR("Underruns:", under.count, " empty ms:", under.total_ms, " longest:", under.longest_ms);
+      if (under.longest_ms) SERIAL_ECHOPAIR(" at line:", under.longest_line);
+      if (under.low_water != 0xFF) SERIAL_ECHOPAIR(" low water:", int(under.low_water), " of ", int(BLOCK_BUFFER_LEN));
+      SERIAL_EOL();
+    #endif
+    #if ENABLED(PLANNER_FIXED_POINT_CHECK)
+      const fixed_point_error_t &err = fixed_point_error;
+      SERIAL_ECHOLNPAIR("Fixed-point checks:", err.checks, " max error steps:", err.steps, " rate:", err.rate, " ticks:", err.ticks);
+    #endif
+  }
+
+  void Planner::reset_stats() {
+    #if ENABLED(PLANNER_LOOKAHEAD_STATS)
+      lookahead_stats = { 0 };
+    #endif
+    #if ENABLED(PLANNER_UNDERRUN_STATS)
+      const bool was_enabled = stepper.suspend();
+      underrun_stats = { 0, 0, 0, 0, 0xFF };
+      if (was_enabled) stepper.wake_up();
+    #endif
+    #if ENABLED(PLANNER_FIXED_POINT_CHECK)
+      fixed_point_error = { 0 };
+    #endif
+  }
+
+#endif
+
+#if ENABLED(PLANNER_UNDERRUN_STATS)
+
+  // The stepper ISR updates the stats, so copy them with it held off
+  underrun_stats_t Planner::get_underrun_stats() {
+    const bool was_enabled = stepper.suspend();
+    const underrun_stats_t stats = underrun_stats;
+    if (was_enabled) stepper.wake_up();
+    return stats;
+  }
+
+#endif
+
 #if ENABLED(AUTOTEMP)
 
   void Planner::getHighESpeed() {
@@ -1619,6 +1911,10 @@ float Planner::get_axis_position_mm(const AxisEnum axis) {
  * Block until all buffered steps are executed / cleaned
  */
 void Planner::synchronize() {
+  #if HAS_GCODE_WAIT
+    REMEMBER(gw, gcode_wait, true);
+    gcode_waits++;
+  #endif
   while (
     has_blocks_queued() || cleaning_buffer_counter
     #if ENABLED(EXTERNAL_CLOSED_LOOP_CONTROLLER)
@@ -1888,7 +2184,7 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
     if (millimeters)
       block->millimeters = millimeters;
     else
-      block->millimeters = SQRT(
+      block->millimeters = TERN(PLANNER_FIXED_POINT, fp_sqrtf, SQRT)(
         #if CORE_IS_XY
           sq(steps_dist_mm.head.x) + sq(steps_dist_mm.head.y) + sq(steps_dist_mm.z)
         #elif CORE_IS_XZ
@@ -1993,14 +2289,14 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
         #if HAS_DUPLICATION_MODE
           if (extruder_duplication_enabled && extruder == 0) {
             ENABLE_AXIS_E1();
-            g_uc_extruder_last_move[1] = (BLOCK_BUFFER_SIZE) * 2;
+            g_uc_extruder_last_move[1] = (BLOCK_BUFFER_LEN) * 2;
           }
         #endif
 
         #define ENABLE_ONE_E(N) do{ \
           if (extruder == N) { \
             ENABLE_AXIS_E##N(); \
-            g_uc_extruder_last_move[N] = (BLOCK_BUFFER_SIZE) * 2; \
+            g_uc_extruder_last_move[N] = (BLOCK_BUFFER_LEN) * 2; \
           } \
           else if (!g_uc_extruder_last_move[N]) \
             DISABLE_AXIS_E##N(); \
@@ -2040,7 +2336,7 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
     #ifndef SLOWDOWN_DIVISOR
       #define SLOWDOWN_DIVISOR 2
     #endif
-    if (WITHIN(moves_queued, 2, (BLOCK_BUFFER_SIZE) / (SLOWDOWN_DIVISOR) - 1)) {
+    if (WITHIN(moves_queued, 2, (BLOCK_BUFFER_LEN) / (SLOWDOWN_DIVISOR) - 1)) {
       if (segment_time_us < settings.min_segment_time_us) {
         // buffer is draining, add extra time.  The amount of time added increases if the buffer is still emptied more.
         const uint32_t nst = segment_time_us + LROUND(2 * (settings.min_segment_time_us - segment_time_us) / moves_queued);
@@ -2248,6 +2544,14 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
   }
   block->acceleration_steps_per_s2 = accel;
   block->acceleration = accel / steps_per_mm;
+  #if ENABLED(PLANNER_FIXED_POINT)
+    // Constants for the fixed-point trapezoid. Zero falls back to the float path.
+    block->steps_per_mm_sqr = sq(steps_per_mm);
+    block->acceleration_inverse = accel ? fp_inverse_2x(accel, block->acceleration_inverse_shift) : 0;
+    #if ENABLED(S_CURVE_ACCELERATION)
+      block->rate_change_ticks = accel ? uint32_t((STEPPER_TIMER_RATE) * 256.0f / accel) : 0;
+    #endif
+  #endif
   #if DISABLED(S_CURVE_ACCELERATION)
     block->acceleration_rate = (uint32_t)(accel * (4096.0f * 4096.0f / (STEPPER_TIMER_RATE)));
   #endif
@@ -2808,6 +3112,9 @@ void Planner::reset_acceleration_rates() {
     if (AXIS_CONDITION) NOLESS(highest_rate, max_acceleration_steps_per_s2[i]);
   }
   cutoff_long = 4294967295UL / highest_rate; // 0xFFFFFFFFUL
+  #if ENABLED(PLANNER_FIXED_POINT) && DISABLED(CLASSIC_JERK)
+    LOOP_XYZE(i) max_acceleration_inverse[i] = 1.0f / settings.max_acceleration_mm_per_s2[i];
+  #endif
   #if HAS_LINEAR_E_JERK
     recalculate_max_e_jerk();
   #endif
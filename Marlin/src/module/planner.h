@@ -55,6 +55,10 @@
   #include "../feature/spindle_laser.h"
 #endif
 
+#if ENABLED(PLANNER_FIXED_POINT)
+  #include "../libs/fixed_point.h"
+#endif
+
 // Feedrate for manual moves
 #ifdef MANUAL_FEEDRATE
   constexpr xyze_feedrate_t _mf = MANUAL_FEEDRATE,
@@ -99,20 +103,14 @@ enum BlockFlag : char {
  */
 typedef struct block_t {
 
-  volatile uint8_t flag;                    // Block flags (See BlockFlag enum above) - Modified by ISR and main thread!
+  /**
+   * Fields read by the Stepper ISR while the block executes.
+   * The byte-sized fields come first so 32-bit targets don't pad between them.
+   */
 
-  // Fields used by the motion planner to manage acceleration
-  float nominal_speed_sqr,                  // The nominal speed for this block in (mm/sec)^2
-        entry_speed_sqr,                    // Entry speed at previous-current junction in (mm/sec)^2
-        max_entry_speed_sqr,                // Maximum allowable junction entry speed in (mm/sec)^2
-        millimeters,                        // The total travel of this block in mm
-        acceleration;                       // acceleration mm/sec^2
+  volatile uint8_t flag;                    // Block flags (See BlockFlag enum above) - Modified by ISR and main thread!
 
-  union {
-    abce_ulong_t steps;                     // Step count along each axis
-    abce_long_t position;                   // New position to force when this sync block is executed
-  };
-  uint32_t step_event_count;                // The number of step events required to complete this block
+  uint8_t direction_bits;                   // The direction bit set for this block (refers to *_DIRECTION_BIT in config.h)
 
   #if EXTRUDERS > 1
     uint8_t extruder;                       // The extruder to move (if E move)
@@ -120,10 +118,16 @@ typedef struct block_t {
     static constexpr uint8_t extruder = 0;
   #endif
 
-  #if ENABLED(MIXING_EXTRUDER)
-    MIXER_BLOCK_FIELD;                      // Normalized color for the mixing steppers
+  #if ENABLED(LIN_ADVANCE)
+    bool use_advance_lead;
   #endif
 
+  union {
+    abce_ulong_t steps;                     // Step count along each axis
+    abce_long_t position;                   // New position to force when this sync block is executed
+  };
+  uint32_t step_event_count;                // The number of step events required to complete this block
+
   // Settings for the trapezoid generator
   uint32_t accelerate_until,                // The index of the step event on which to stop acceleration
            decelerate_after;                // The index of the step event on which to start decelerating
@@ -138,34 +142,25 @@ typedef struct block_t {
     uint32_t acceleration_rate;             // The acceleration rate used for acceleration calculation
   #endif
 
-  uint8_t direction_bits;                   // The direction bit set for this block (refers to *_DIRECTION_BIT in config.h)
+  uint32_t nominal_rate,                    // The nominal step rate for this block in step_events/sec
+           initial_rate,                    // The jerk-adjusted step rate at start of block
+           final_rate;                      // The minimal rate at exit
 
   // Advance extrusion
   #if ENABLED(LIN_ADVANCE)
-    bool use_advance_lead;
     uint16_t advance_speed,                 // STEP timer value for extruder speed offset ISR
              max_adv_steps,                 // max. advance steps to get cruising speed pressure (not always nominal_speed!)
              final_adv_steps;               // advance steps due to exit speed
-    float e_D_ratio;
   #endif
 
-  uint32_t nominal_rate,                    // The nominal step rate for this block in step_events/sec
-           initial_rate,                    // The jerk-adjusted step rate at start of block
-           final_rate,                      // The minimal rate at exit
-           acceleration_steps_per_s2;       // acceleration steps/sec^2
+  #if ENABLED(MIXING_EXTRUDER)
+    MIXER_BLOCK_FIELD;                      // Normalized color for the mixing steppers
+  #endif
 
   #if HAS_CUTTER
     cutter_power_t cutter_power;            // Power level for Spindle, Laser, etc.
   #endif
 
-  #if FAN_COUNT > 0
-    uint8_t fan_speed[FAN_COUNT];
-  #endif
-
-  #if ENABLED(BARICUDA)
-    uint8_t valve_pressure, e_to_p_pressure;
-  #endif
-
   #if HAS_SPI_LCD
     uint32_t segment_time_us;
   #endif
@@ -174,11 +169,52 @@ typedef struct block_t {
     uint32_t sdpos;
   #endif
 
+  /**
+   * Fields used only by the motion planner to manage acceleration.
+   * The ISR never reads these once the block is busy.
+   */
+
+  float nominal_speed_sqr,                  // The nominal speed for this block in (mm/sec)^2
+        entry_speed_sqr,                    // Entry speed at previous-current junction in (mm/sec)^2
+        max_entry_speed_sqr,                // Maximum allowable junction entry speed in (mm/sec)^2
+        millimeters,                        // The total travel of this block in mm
+        acceleration;                       // acceleration mm/sec^2
+
+  uint32_t acceleration_steps_per_s2;       // acceleration steps/sec^2
+
+  #if ENABLED(LIN_ADVANCE)
+    float e_D_ratio;
+  #endif
+
+  #if ENABLED(PLANNER_FIXED_POINT)
+    #if ENABLED(S_CURVE_ACCELERATION)
+      uint32_t rate_change_ticks;           // STEP timer ticks per step/s of rate change, as Q24.8
+    #endif
+    float steps_per_mm_sqr;                 // (steps/mm)^2 along the move, for step rates from squared speeds
+    uint32_t acceleration_inverse;          // 1 / (2 * acceleration_steps_per_s2) as a normalized reciprocal...
+    uint8_t acceleration_inverse_shift;     // ...and its shift. See fixed_point.h
+  #endif
+
+  #if FAN_COUNT > 0
+    uint8_t fan_speed[FAN_COUNT];
+  #endif
+
+  #if ENABLED(BARICUDA)
+    uint8_t valve_pressure, e_to_p_pressure;
+  #endif
+
 } block_t;
 
 #define HAS_POSITION_FLOAT ANY(LIN_ADVANCE, SCARA_FEEDRATE_SCALING, GRADIENT_MIX, LCD_SHOW_E_TOTAL)
 
-#define BLOCK_MOD(n) ((n)&(BLOCK_BUFFER_SIZE-1))
+// The ring size is fixed, or chosen at startup with BLOCK_BUFFER_AUTO_SIZE
+#if ENABLED(BLOCK_BUFFER_AUTO_SIZE)
+  #define BLOCK_BUFFER_LEN Planner::block_buffer_size
+#else
+  #define BLOCK_BUFFER_LEN BLOCK_BUFFER_SIZE
+#endif
+
+#define BLOCK_MOD(n) ((n)&(BLOCK_BUFFER_LEN-1))
 
 typedef struct {
    uint32_t max_acceleration_mm_per_s2[XYZE_N], // (mm/s^2) M201 XYZE
@@ -192,6 +228,33 @@ typedef struct {
             min_travel_feedrate_mm_s;           // (mm/s) M205 T - Minimum travel feedrate
 } planner_settings_t;
 
+#if ENABLED(PLANNER_LOOKAHEAD_STATS)
+  typedef struct {
+    uint32_t appends,         // Calls to recalculate(), one per queued block
+             blocks_touched;  // Blocks visited by the look-ahead passes, in total
+    uint8_t max_touched;      // Most blocks visited for a single append
+  } lookahead_stats_t;
+#endif
+
+#if ENABLED(PLANNER_UNDERRUN_STATS)
+  typedef struct {
+    uint32_t count,           // Times the buffer ran empty during a print
+             total_ms,        // Time spent empty, in total
+             longest_ms,      // Longest time spent empty
+             longest_line;    // G-code line being processed when the longest one began
+    uint8_t low_water;        // Fewest moves queued when the stepper took a block, 0xFF if none yet
+  } underrun_stats_t;
+#endif
+
+#if ENABLED(PLANNER_FIXED_POINT_CHECK)
+  typedef struct {
+    uint32_t checks,          // Trapezoids calculated both ways
+             steps,           // Largest difference in accelerate_until / decelerate_after
+             rate,            // Largest difference in an entry, exit or cruise rate
+             ticks;           // Largest difference in acceleration / deceleration time
+  } fixed_point_error_t;
+#endif
+
 #if DISABLED(SKEW_CORRECTION)
   #define XY_SKEW_FACTOR 0
   #define XZ_SKEW_FACTOR 0
@@ -228,7 +291,12 @@ class Planner {
      *  Writer of head is Planner::buffer_segment().
      *  Reader of tail is Stepper::isr(). Always consider tail busy / read-only
      */
-    static block_t block_buffer[BLOCK_BUFFER_SIZE];
+    #if ENABLED(BLOCK_BUFFER_AUTO_SIZE)
+      static block_t *block_buffer;                 // Allocated by allocate_block_buffer()
+      static uint8_t block_buffer_size;             // A power of 2, at least BLOCK_BUFFER_SIZE
+    #else
+      static block_t block_buffer[BLOCK_BUFFER_SIZE];
+    #endif
     static volatile uint8_t block_buffer_head,      // Index of the next block to be pushed
                             block_buffer_nonbusy,   // Index of the first non busy block
                             block_buffer_planned,   // Index of the optimally planned block
@@ -255,7 +323,29 @@ class Planner {
 
     static planner_settings_t settings;
 
+    #if ENABLED(PLANNER_LOOKAHEAD_STATS)
+      static lookahead_stats_t lookahead_stats;
+    #endif
+    #if ENABLED(PLANNER_UNDERRUN_STATS)
+      static underrun_stats_t underrun_stats;
+      static underrun_stats_t get_underrun_stats();
+    #endif
+    #if HAS_GCODE_WAIT
+      static bool gcode_wait;       // A G-code waits on purpose (M400, G4, M109...), so running dry isn't an underrun
+      static uint8_t gcode_waits;   // Waits begun, so a traced loop step can tell it waited
+    #endif
+    #if ENABLED(PLANNER_FIXED_POINT_CHECK)
+      static fixed_point_error_t fixed_point_error;
+    #endif
+    #if HAS_PLANNER_REPORT
+      static void report_stats();
+      static void reset_stats();
+    #endif
+
     static uint32_t max_acceleration_steps_per_s2[XYZE_N]; // (steps/s^2) Derived from mm_per_s2
+    #if ENABLED(PLANNER_FIXED_POINT) && DISABLED(CLASSIC_JERK)
+      static float max_acceleration_inverse[XYZE]; // (s^2/mm) 1 / mm_per_s2, for the junction limit
+    #endif
     static float steps_to_mm[XYZE_N];           // Millimeters per step
 
     #if DISABLED(CLASSIC_JERK)
@@ -354,6 +444,12 @@ class Planner {
       volatile static uint32_t block_buffer_runtime_us; //Theoretical block buffer runtime in µs
     #endif
 
+    #if ENABLED(PLANNER_UNDERRUN_STATS)
+      static bool was_moving, in_underrun;  // A block was taken since the buffer was empty / The buffer ran empty during a print
+      static millis_t underrun_start_ms;
+      static uint32_t underrun_line;
+    #endif
+
   public:
 
     /**
@@ -368,6 +464,10 @@ class Planner {
      * Static (class) Methods
      */
 
+    #if ENABLED(BLOCK_BUFFER_AUTO_SIZE)
+      static void allocate_block_buffer();
+    #endif
+
     static void reset_acceleration_rates();
     static void refresh_positioning();
     static void set_max_acceleration(const uint8_t axis, float targetValue);
@@ -557,7 +657,7 @@ class Planner {
     FORCE_INLINE static bool is_full() { return block_buffer_tail == next_block_index(block_buffer_head); }
 
     // Get count of movement slots free
-    FORCE_INLINE static uint8_t moves_free() { return BLOCK_BUFFER_SIZE - 1 - movesplanned(); }
+    FORCE_INLINE static uint8_t moves_free() { return BLOCK_BUFFER_LEN - 1 - movesplanned(); }
 
     /**
      * Planner::get_next_free_block
@@ -824,8 +924,8 @@ class Planner {
     /**
      * Get the index of the next / previous block in the ring buffer
      */
-    static constexpr uint8_t next_block_index(const uint8_t block_index) { return BLOCK_MOD(block_index + 1); }
-    static constexpr uint8_t prev_block_index(const uint8_t block_index) { return BLOCK_MOD(block_index - 1); }
+    FORCE_INLINE static uint8_t next_block_index(const uint8_t block_index) { return BLOCK_MOD(block_index + 1); }
+    FORCE_INLINE static uint8_t prev_block_index(const uint8_t block_index) { return BLOCK_MOD(block_index - 1); }
 
     /**
      * Calculate the distance (not time) it takes to accelerate
@@ -867,15 +967,22 @@ class Planner {
       }
     #endif
 
-    static void calculate_trapezoid_for_block(block_t* const block, const float &entry_factor, const float &exit_factor);
+    #if ENABLED(PLANNER_FIXED_POINT)
+      static uint32_t rate_for_speed_sqr(const block_t* const block, const float &speed_sqr);
+      static void calculate_trapezoid_for_rates(block_t* const block, uint32_t initial_rate, uint32_t final_rate);
+      static void calculate_trapezoid_fixed(block_t* const block, const uint32_t initial_rate, const uint32_t final_rate);
+    #else
+      static void calculate_trapezoid_for_block(block_t* const block, const float &entry_factor, const float &exit_factor);
+    #endif
+    static void calculate_trapezoid_float(block_t* const block, const uint32_t initial_rate, const uint32_t final_rate);
 
-    static void reverse_pass_kernel(block_t* const current, const block_t * const next);
+    static bool reverse_pass_kernel(block_t* const current, const block_t * const next);
     static void forward_pass_kernel(const block_t * const previous, block_t* const current, uint8_t block_index);
 
-    static void reverse_pass();
-    static void forward_pass();
+    static uint8_t reverse_pass();
+    static void forward_pass(uint8_t block_index);
 
-    static void recalculate_trapezoids();
+    static void recalculate_trapezoids(uint8_t block_index);
 
     static void recalculate();
 
@@ -888,10 +995,14 @@ class Planner {
       }
 
       FORCE_INLINE static float limit_value_by_axis_maximum(const float &max_value, xyze_float_t &unit_vec) {
-        float limit_value = max_value;
-        LOOP_XYZE(idx) if (unit_vec[idx]) // Avoid divide by zero
-          NOMORE(limit_value, ABS(settings.max_acceleration_mm_per_s2[idx] / unit_vec[idx]));
-        return limit_value;
+        #if ENABLED(PLANNER_FIXED_POINT)
+          return fp_limit_by_axes(max_value, unit_vec, max_acceleration_inverse, XYZE);
+        #else
+          float limit_value = max_value;
+          LOOP_XYZE(idx) if (unit_vec[idx]) // Avoid divide by zero
+            NOMORE(limit_value, ABS(settings.max_acceleration_mm_per_s2[idx] / unit_vec[idx]));
+          return limit_value;
+        #endif
       }
 
     #endif // !CLASSIC_JERK
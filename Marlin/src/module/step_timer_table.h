@@ -0,0 +1,88 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * step_timer_table.h - Step timer interval without a division
+ *
+ * STEPPER_TIMER_RATE / step_rate is worked out as STEPPER_TIMER_RATE times
+ * the reciprocal of the step rate. The rate is normalized by its highest
+ * set bit to x in [1, 2), and 1/x comes from a table of Q31 reciprocals
+ * generated by the compiler. Entry i is 2^31 / (1 + i / SIZE).
+ *
+ *  STEP_TIMER_TABLE      : Interpolate between the two nearest entries.
+ *  STEP_TIMER_RECIPROCAL : Also refine the result with one Newton-Raphson
+ *                          step, r = r * (2 - x * r), which squares the
+ *                          error. With 64 or 256 entries the interval is
+ *                          then within a tick of the division. With 16 it
+ *                          is within 3 ticks (20 ppm) at 100 MHz.
+ *
+ * buildroot/share/scripts/step_timer_test.py sweeps every step rate on the
+ * host and lists the error for each timer rate, table size and mode.
+ *
+ * The remaining multiplies and shifts are cheap on Cortex-M0 and M3, where
+ * a 32-bit division is a slow library call or a 2-12 cycle instruction.
+ */
+
+#include "../inc/MarlinConfig.h"
+
+#define STEP_TIMER_TABLE_BITS (STEP_TIMER_TABLE_SIZE == 256 ? 8 : STEP_TIMER_TABLE_SIZE == 64 ? 6 : 4)
+
+// 2^31 * SIZE / (SIZE + i), rounded
+constexpr uint32_t step_timer_recip(const uint32_t i) {
+  return uint32_t(((uint64_t(1) << 31) * (STEP_TIMER_TABLE_SIZE) + ((STEP_TIMER_TABLE_SIZE) + i) / 2) / ((STEP_TIMER_TABLE_SIZE) + i));
+}
+
+#define _STT4(I)   step_timer_recip(I), step_timer_recip(I + 1), step_timer_recip(I + 2), step_timer_recip(I + 3)
+#define _STT16(I)  _STT4(I), _STT4(I + 4), _STT4(I + 8), _STT4(I + 12)
+#define _STT64(I)  _STT16(I), _STT16(I + 16), _STT16(I + 32), _STT16(I + 48)
+#define _STT256(I) _STT64(I), _STT64(I + 64), _STT64(I + 128), _STT64(I + 192)
+#define __STT(N)   _STT##N(0), step_timer_recip(N)
+#define _STT(N)    __STT(N)
+
+// The last entry closes the octave, 2^30 for x = 2
+const uint32_t step_timer_table[(STEP_TIMER_TABLE_SIZE) + 1] = { _STT(STEP_TIMER_TABLE_SIZE) };
+
+/**
+ * Return STEPPER_TIMER_RATE / step_rate for a non-zero step_rate,
+ * as close as the table size and mode allow
+ */
+FORCE_INLINE uint32_t step_timer_interval(const uint32_t step_rate) {
+  constexpr uint8_t k = STEP_TIMER_TABLE_BITS;
+
+  // Normalize to Q31 x in [1, 2): the octave is 'e', the index the next k bits
+  const uint8_t e = 31 - __builtin_clz(step_rate);
+  const uint32_t x = step_rate << (31 - e);
+  const uint32_t i = (x >> (31 - k)) & ((STEP_TIMER_TABLE_SIZE) - 1);
+
+  // Interpolate with the k bits after the index
+  const uint32_t f = (x >> (31 - 2 * k)) & ((STEP_TIMER_TABLE_SIZE) - 1);
+  uint32_t r = step_timer_table[i] - (((step_timer_table[i] - step_timer_table[i + 1]) * f) >> k);
+
+  #if ENABLED(STEP_TIMER_RECIPROCAL)
+    const uint32_t t = uint32_t(((uint64_t(1) << 63) - uint64_t(x) * r) >> 31);  // Q31 (2 - x * r), about 1
+    r = uint32_t((uint64_t(r) * t) >> 31);
+  #endif
+
+  // STEPPER_TIMER_RATE * (1 / x) / 2^e
+  return uint32_t((uint64_t(STEPPER_TIMER_RATE) * r) >> (31 + e));
+}
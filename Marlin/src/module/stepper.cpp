@@ -102,6 +102,7 @@ Stepper stepper; // Singleton
 #include "../sd/cardreader.h"
 #include "../MarlinCore.h"
 #include "../HAL/shared/Delay.h"
+#include "../feature/stepper_profile.h"
 
 #if ENABLED(INTEGRATED_BABYSTEPPING)
   #include "../feature/babystep.h"
@@ -227,7 +228,14 @@ uint32_t Stepper::advance_divisor = 0,
   uint32_t Stepper::nextBabystepISR = BABYSTEP_NEVER;
 #endif
 
+#if ENABLED(STEP_TIMING_QUEUE)
+  Stepper::step_timing_t Stepper::timing_queue[STEP_TIMING_QUEUE_SIZE];
+  uint8_t Stepper::timing_head, Stepper::timing_tail; // = 0
+  uint32_t Stepper::timing_events;
+#endif
+
 int32_t Stepper::ticks_nominal = -1;
+uint8_t Stepper::loops_nominal;
 #if DISABLED(S_CURVE_ACCELERATION)
   uint32_t Stepper::acc_step_rate; // needed for deceleration start point
 #endif
@@ -1350,6 +1358,10 @@ void Stepper::isr() {
   // periods to big periods are respected and the timer does not reset to 0
   HAL_timer_set_compare(STEP_TIMER_NUM, hal_timer_t(HAL_TIMER_TYPE_MAX));
 
+  #if ENABLED(STEPPER_ISR_PROFILE)
+    const hal_timer_t isr_start = StepperProfile::now();
+  #endif
+
   // Count of ticks for the next ISR
   hal_timer_t next_isr_ticks = 0;
 
@@ -1362,20 +1374,24 @@ void Stepper::isr() {
     // Enable ISRs to reduce USART processing latency
     ENABLE_ISRS();
 
-    if (!nextMainISR) pulse_phase_isr();                            // 0 = Do coordinated axes Stepper pulses
+    if (!nextMainISR) ISR_PROFILE(ISR_PHASE_PULSE, pulse_phase_isr()); // 0 = Do coordinated axes Stepper pulses
 
     #if ENABLED(LIN_ADVANCE)
-      if (!nextAdvanceISR) nextAdvanceISR = advance_isr();          // 0 = Do Linear Advance E Stepper pulses
+      if (!nextAdvanceISR) ISR_PROFILE(ISR_PHASE_ADVANCE, nextAdvanceISR = advance_isr()); // 0 = Do Linear Advance E Stepper pulses
     #endif
 
     #if ENABLED(INTEGRATED_BABYSTEPPING)
       const bool is_babystep = (nextBabystepISR == 0);              // 0 = Do Babystepping (XY)Z pulses
-      if (is_babystep) nextBabystepISR = babystepping_isr();
+      if (is_babystep) ISR_PROFILE(ISR_PHASE_BABYSTEP, nextBabystepISR = babystepping_isr());
     #endif
 
     // ^== Time critical. NOTHING besides pulse generation should be above here!!!
 
-    if (!nextMainISR) nextMainISR = block_phase_isr();  // Manage acc/deceleration, get next block
+    #if ENABLED(STEPPER_ISR_PROFILE)
+      if (!nextMainISR) StepperProfile::multistep(steps_per_isr); // The multiplier this pulse phase ran at
+    #endif
+
+    if (!nextMainISR) ISR_PROFILE(ISR_PHASE_BLOCK, nextMainISR = block_phase_isr()); // Manage acc/deceleration, get next block
 
     #if ENABLED(INTEGRATED_BABYSTEPPING)
       if (is_babystep)                                  // Avoid ANY stepping too soon after baby-stepping
@@ -1471,7 +1487,12 @@ void Stepper::isr() {
      * loop to 10 iterations. Beyond that, there's no way to ensure correct pulse
      * timing, since the MCU isn't fast enough.
      */
-    if (!--max_loops) next_isr_ticks = min_ticks;
+    if (!--max_loops) {
+      next_isr_ticks = min_ticks;
+      #if ENABLED(STEPPER_ISR_PROFILE)
+        StepperProfile::max_loops_hit++;
+      #endif
+    }
 
     // Advance pulses if not enough time to wait for the next ISR
   } while (next_isr_ticks < min_ticks);
@@ -1479,6 +1500,10 @@ void Stepper::isr() {
   // Now 'next_isr_ticks' contains the period to the next Stepper ISR - And we are
   // sure that the time has not arrived yet - Warrantied by the scheduler
 
+  #if ENABLED(STEPPER_ISR_PROFILE)
+    StepperProfile::record(ISR_PHASE_TOTAL, isr_start);
+  #endif
+
   // Set the next ISR to fire at the proper time
   HAL_timer_set_compare(STEP_TIMER_NUM, hal_timer_t(next_isr_ticks));
 
@@ -1645,6 +1670,147 @@ void Stepper::pulse_phase_isr() {
   } while (--events_to_do);
 }
 
+/**
+ * Work out the timer interval and steps per ISR of the next block phase of the
+ * current block, and whether it falls in the acceleration, cruise or deceleration.
+ * 'events' is the step_events_completed that the block phase will start from.
+ * This advances the acceleration state, so every block phase must be worked out
+ * once and in order, by the stepper ISR or (with STEP_TIMING_QUEUE) ahead of it.
+ */
+FORCE_INLINE uint32_t Stepper::calc_block_interval(const uint32_t events, uint8_t &loops, BlockPhase &phase) {
+  uint32_t interval;
+
+  // Are we in acceleration phase ?
+  if (events <= accelerate_until) { // Calculate new timer value
+    phase = BLOCK_PHASE_ACCEL;
+
+    #if ENABLED(S_CURVE_ACCELERATION)
+      // Get the next speed to use (Jerk limited!)
+      uint32_t acc_step_rate =
+        acceleration_time < current_block->acceleration_time
+          ? _eval_bezier_curve(acceleration_time)
+          : current_block->cruise_rate;
+    #else
+      acc_step_rate = STEP_MULTIPLY(acceleration_time, current_block->acceleration_rate) + current_block->initial_rate;
+      NOMORE(acc_step_rate, current_block->nominal_rate);
+    #endif
+
+    // acc_step_rate is in steps/second
+
+    // step_rate to timer interval and steps per stepper isr
+    interval = calc_timer_interval(acc_step_rate, &loops);
+    acceleration_time += interval;
+  }
+  // Are we in Deceleration phase ?
+  else if (events > decelerate_after) {
+    phase = BLOCK_PHASE_DECEL;
+    uint32_t step_rate;
+
+    #if ENABLED(S_CURVE_ACCELERATION)
+      // If this is the 1st time we process the 2nd half of the trapezoid...
+      if (!bezier_2nd_half) {
+        // Initialize the Bézier speed curve
+        _calc_bezier_curve_coeffs(current_block->cruise_rate, current_block->final_rate, current_block->deceleration_time_inverse);
+        bezier_2nd_half = true;
+        // The first point starts at cruise rate. Just save evaluation of the Bézier curve
+        step_rate = current_block->cruise_rate;
+      }
+      else {
+        // Calculate the next speed to use
+        step_rate = deceleration_time < current_block->deceleration_time
+          ? _eval_bezier_curve(deceleration_time)
+          : current_block->final_rate;
+      }
+    #else
+
+      // Using the old trapezoidal control
+      step_rate = STEP_MULTIPLY(deceleration_time, current_block->acceleration_rate);
+      if (step_rate < acc_step_rate) { // Still decelerating?
+        step_rate = acc_step_rate - step_rate;
+        NOLESS(step_rate, current_block->final_rate);
+      }
+      else
+        step_rate = current_block->final_rate;
+    #endif
+
+    // step_rate is in steps/second
+
+    // step_rate to timer interval and steps per stepper isr
+    interval = calc_timer_interval(step_rate, &loops);
+    deceleration_time += interval;
+  }
+  // We must be in cruise phase otherwise
+  else {
+    phase = BLOCK_PHASE_CRUISE;
+
+    // Calculate the ticks_nominal for this nominal speed, if not done yet
+    if (ticks_nominal < 0) {
+      // step_rate to timer interval and loops for the nominal speed
+      ticks_nominal = calc_timer_interval(current_block->nominal_rate, &loops_nominal);
+    }
+
+    // The timer interval is just the nominal value for the nominal speed
+    interval = ticks_nominal;
+    loops = loops_nominal;
+  }
+
+  return interval;
+}
+
+#if ENABLED(STEP_TIMING_QUEUE)
+
+  #define NEXT_TIMING(I) (((I) + 1) & ((STEP_TIMING_QUEUE_SIZE) - 1))
+
+  /**
+   * Work out the next block phase of the current block and add it to the
+   * timing queue, as part of the last run if it continues it. Called with
+   * the stepper ISR held off. Return false if the queue is full or the rest
+   * of the block is already queued.
+   */
+  bool Stepper::queue_timing() {
+    if (!current_block || abort_current_block) return false;
+
+    // With nothing queued, follow on from the block phase the ISR is running now
+    const bool empty = timing_head == timing_tail;
+    if (empty) timing_events = _MIN(step_events_completed + steps_per_isr, step_event_count);
+    if (timing_events >= step_event_count || NEXT_TIMING(timing_tail) == timing_head) return false;
+
+    uint8_t loops;
+    BlockPhase phase;
+    const uint32_t interval = calc_block_interval(timing_events, loops, phase);
+    timing_events = _MIN(timing_events + loops, step_event_count);
+
+    if (!empty) {
+      step_timing_t &run = timing_queue[(timing_tail - 1) & ((STEP_TIMING_QUEUE_SIZE) - 1)];
+      if (run.phase == phase && run.loops == loops && run.count < 255) {
+        if (run.count == 1) {
+          const int32_t delta = int32_t(interval - run.interval);
+          if (WITHIN(delta, INT16_MIN, INT16_MAX)) { run.delta = delta; run.count = 2; return true; }
+        }
+        else if (interval == run.interval + uint32_t(int32_t(run.count) * run.delta)) {
+          run.count++;
+          return true;
+        }
+      }
+    }
+
+    timing_queue[timing_tail] = { interval, 0, 1, loops, phase };
+    timing_tail = NEXT_TIMING(timing_tail);
+    return true;
+  }
+
+  void Stepper::fill_timing_queue() {
+    // Hold off the ISR for one block phase at a time, to keep its latency down
+    LOOP_L_N(i, STEP_TIMING_QUEUE_SIZE) {
+      const bool was_enabled = suspend();
+      const bool queued = queue_timing();
+      if (was_enabled) wake_up();
+      if (!queued) break;
+    }
+  }
+
+#endif // STEP_TIMING_QUEUE
+
 // This is the last half of the stepper interrupt: This one processes and
 // properly schedules blocks from the planner. This is executed after creating
 // the step pulses, so it is not time critical, as pulses are already done.
@@ -1668,98 +1834,58 @@ uint32_t Stepper::block_phase_isr() {
     }
     else {
       // Step events not completed yet...
+      BlockPhase phase;
+
+      #if ENABLED(STEP_TIMING_QUEUE)
+        if (timing_head != timing_tail) {
+          // Take the next block phase worked out ahead of time
+          step_timing_t &run = timing_queue[timing_head];
+          interval = run.interval;
+          steps_per_isr = run.loops;
+          phase = run.phase;
+          run.interval += run.delta;
+          if (!--run.count) timing_head = NEXT_TIMING(timing_head);
+          #if ENABLED(STEPPER_ISR_PROFILE)
+            StepperProfile::timing_queued++;
+          #endif
+        }
+        else {
+          interval = calc_block_interval(step_events_completed, steps_per_isr, phase);
+          #if ENABLED(STEPPER_ISR_PROFILE)
+            StepperProfile::timing_inline++;
+          #endif
+        }
+      #else
+        interval = calc_block_interval(step_events_completed, steps_per_isr, phase);
+      #endif
 
-      // Are we in acceleration phase ?
-      if (step_events_completed <= accelerate_until) { // Calculate new timer value
-
-        #if ENABLED(S_CURVE_ACCELERATION)
-          // Get the next speed to use (Jerk limited!)
-          uint32_t acc_step_rate =
-            acceleration_time < current_block->acceleration_time
-              ? _eval_bezier_curve(acceleration_time)
-              : current_block->cruise_rate;
-        #else
-          acc_step_rate = STEP_MULTIPLY(acceleration_time, current_block->acceleration_rate) + current_block->initial_rate;
-          NOMORE(acc_step_rate, current_block->nominal_rate);
-        #endif
-
-        // acc_step_rate is in steps/second
-
-        // step_rate to timer interval and steps per stepper isr
-        interval = calc_timer_interval(acc_step_rate, &steps_per_isr);
-        acceleration_time += interval;
-
-        #if ENABLED(LIN_ADVANCE)
-          // Fire ISR if final adv_rate is reached
-          if (LA_steps && (!LA_use_advance_lead || LA_isr_rate != current_block->advance_speed))
-            initiateLA();
-        #endif
-      }
-      // Are we in Deceleration phase ?
-      else if (step_events_completed > decelerate_after) {
-        uint32_t step_rate;
-
-        #if ENABLED(S_CURVE_ACCELERATION)
-          // If this is the 1st time we process the 2nd half of the trapezoid...
-          if (!bezier_2nd_half) {
-            // Initialize the Bézier speed curve
-            _calc_bezier_curve_coeffs(current_block->cruise_rate, current_block->final_rate, current_block->deceleration_time_inverse);
-            bezier_2nd_half = true;
-            // The first point starts at cruise rate. Just save evaluation of the Bézier curve
-            step_rate = current_block->cruise_rate;
-          }
-          else {
-            // Calculate the next speed to use
-            step_rate = deceleration_time < current_block->deceleration_time
-              ? _eval_bezier_curve(deceleration_time)
-              : current_block->final_rate;
-          }
-        #else
-
-          // Using the old trapezoidal control
-          step_rate = STEP_MULTIPLY(deceleration_time, current_block->acceleration_rate);
-          if (step_rate < acc_step_rate) { // Still decelerating?
-            step_rate = acc_step_rate - step_rate;
-            NOLESS(step_rate, current_block->final_rate);
-          }
-          else
-            step_rate = current_block->final_rate;
-        #endif
-
-        // step_rate is in steps/second
-
-        // step_rate to timer interval and steps per stepper isr
-        interval = calc_timer_interval(step_rate, &steps_per_isr);
-        deceleration_time += interval;
-
-        #if ENABLED(LIN_ADVANCE)
-          if (LA_use_advance_lead) {
-            // Wake up eISR on first deceleration loop and fire ISR if final adv_rate is reached
-            if (step_events_completed <= decelerate_after + steps_per_isr || (LA_steps && LA_isr_rate != current_block->advance_speed)) {
+      #if ENABLED(LIN_ADVANCE)
+        switch (phase) {
+          case BLOCK_PHASE_ACCEL:
+            // Fire ISR if final adv_rate is reached
+            if (LA_steps && (!LA_use_advance_lead || LA_isr_rate != current_block->advance_speed))
               initiateLA();
-              LA_isr_rate = current_block->advance_speed;
-            }
-          }
-          else if (LA_steps) initiateLA();
-        #endif
-      }
-      // We must be in cruise phase otherwise
-      else {
+            break;
 
-        #if ENABLED(LIN_ADVANCE)
-          // If there are any esteps, fire the next advance_isr "now"
-          if (LA_steps && LA_isr_rate != current_block->advance_speed) initiateLA();
-        #endif
+          case BLOCK_PHASE_DECEL:
+            if (LA_use_advance_lead) {
+              // Wake up eISR on first deceleration loop and fire ISR if final adv_rate is reached
+              if (step_events_completed <= decelerate_after + steps_per_isr || (LA_steps && LA_isr_rate != current_block->advance_speed)) {
+                initiateLA();
+                LA_isr_rate = current_block->advance_speed;
+              }
+            }
+            else if (LA_steps) initiateLA();
+            break;
 
-        // Calculate the ticks_nominal for this nominal speed, if not done yet
-        if (ticks_nominal < 0) {
-          // step_rate to timer interval and loops for the nominal speed
-          ticks_nominal = calc_timer_interval(current_block->nominal_rate, &steps_per_isr);
+          case BLOCK_PHASE_CRUISE:
+            // If there are any esteps, fire the next advance_isr "now"
+            if (LA_steps && LA_isr_rate != current_block->advance_speed) initiateLA();
+            break;
         }
-
-        // The timer interval is just the nominal value for the nominal speed
-        interval = ticks_nominal;
-      }
+      #else
+        UNUSED(phase);
+      #endif
     }
   }
 
@@ -1957,6 +2083,11 @@ uint32_t Stepper::block_phase_isr() {
       // Mark the time_nominal as not calculated yet
       ticks_nominal = -1;
 
+      #if ENABLED(STEP_TIMING_QUEUE)
+        // Drop any block phases left over from an aborted block
+        timing_head = timing_tail = 0;
+      #endif
+
       #if DISABLED(S_CURVE_ACCELERATION)
         // Set as deceleration point the initial rate of the block
         acc_step_rate = current_block->initial_rate;
@@ -47,6 +47,11 @@
 #include "stepper/indirection.h"
 #ifdef __AVR__
   #include "speed_lookuptable.h"
+#elif EITHER(STEP_TIMER_TABLE, STEP_TIMER_RECIPROCAL)
+  #include "step_timer_table.h"
+#endif
+#if ENABLED(STEP_TIMER_CHECK)
+  #include "../feature/stepper_profile.h"
 #endif
 
 // Disable multiple steps per ISR
@@ -233,6 +238,9 @@
 // The minimum allowable frequency for step smoothing will be 1/10 of the maximum nominal frequency (in Hz)
 #define MIN_STEP_ISR_FREQUENCY MAX_STEP_ISR_FREQUENCY_1X
 
+// The part of the block a block phase falls in
+enum BlockPhase : uint8_t { BLOCK_PHASE_ACCEL, BLOCK_PHASE_DECEL, BLOCK_PHASE_CRUISE };
+
 //
 // Stepper class definition
 //
@@ -334,7 +342,22 @@ class Stepper {
       static uint32_t nextBabystepISR;
     #endif
 
+    #if ENABLED(STEP_TIMING_QUEUE)
+      // A run of block phases with the same steps per ISR, spaced by a steadily changing interval
+      typedef struct {
+        uint32_t interval;  // Timer interval of the next block phase taken from the run
+        int16_t delta;      // Change in interval from one block phase to the next
+        uint8_t count,      // Block phases left in the run
+                loops;      // Steps per ISR
+        BlockPhase phase;
+      } step_timing_t;
+      static step_timing_t timing_queue[STEP_TIMING_QUEUE_SIZE];
+      static uint8_t timing_head, timing_tail;  // Only changed with the stepper ISR held off
+      static uint32_t timing_events;            // step_events_completed when the next queued run is taken
+    #endif
+
     static int32_t ticks_nominal;
+    static uint8_t loops_nominal;  // Steps per ISR at the nominal speed
     #if DISABLED(S_CURVE_ACCELERATION)
       static uint32_t acc_step_rate; // needed for deceleration start point
     #endif
@@ -482,6 +505,11 @@ class Stepper {
     // Set direction bits for all steppers
     static void set_directions();
 
+    #if ENABLED(STEP_TIMING_QUEUE)
+      // Work out block phases of the running block ahead of the stepper ISR
+      static void fill_timing_queue();
+    #endif
+
   private:
 
     // Set the current position in steps
@@ -522,8 +550,16 @@ class Stepper {
       *loops = multistep;
 
       #ifdef CPU_32_BIT
-        // In case of high-performance processor, it is able to calculate in real-time
-        timer = uint32_t(STEPPER_TIMER_RATE) / step_rate;
+        #if EITHER(STEP_TIMER_TABLE, STEP_TIMER_RECIPROCAL)
+          // Multiply by a reciprocal from the table, for MCUs with a slow division
+          timer = step_timer_interval(step_rate);
+          #if ENABLED(STEP_TIMER_CHECK)
+            StepperProfile::check_timer(timer, uint32_t(STEPPER_TIMER_RATE) / step_rate);
+          #endif
+        #else
+          // In case of high-performance processor, it is able to calculate in real-time
+          timer = uint32_t(STEPPER_TIMER_RATE) / step_rate;
+        #endif
       #else
         constexpr uint32_t min_step_rate = F_CPU / 500000U;
         NOLESS(step_rate, min_step_rate);
@@ -548,6 +584,12 @@ class Stepper {
       return timer;
     }
 
+    static uint32_t calc_block_interval(const uint32_t events, uint8_t &loops, BlockPhase &phase);
+
+    #if ENABLED(STEP_TIMING_QUEUE)
+      static bool queue_timing();
+    #endif
+
     #if ENABLED(S_CURVE_ACCELERATION)
       static void _calc_bezier_curve_coeffs(const int32_t v0, const int32_t v1, const uint32_t av);
       static int32_t _eval_bezier_curve(const uint32_t curr_step);
@@ -93,6 +93,10 @@
   #include "../feature/joystick.h"
 #endif
 
+#if ENABLED(ANYCUBIC_TOUCHSCREEN)
+  #include "../lcd/anycubic_touchscreen.h"
+#endif
+
 #if ENABLED(SINGLENOZZLE)
   #include "tool_change.h"
 #endif
@@ -1036,6 +1040,10 @@ void Temperature::manage_heater() {
 
   updateTemperaturesFromRawValues(); // also resets the watchdog
 
+  #if ENABLED(ANYCUBIC_TOUCHSCREEN)
+    AnycubicTouchscreen.TemperatureUpdated();
+  #endif
+
   #if ENABLED(HEATER_0_USES_MAX6675)
     if (temp_hotend[0].celsius > _MIN(HEATER_0_MAXTEMP, HEATER_0_MAX6675_TMAX - 1.0)) max_temp_error(H_E0);
     if (temp_hotend[0].celsius < _MAX(HEATER_0_MINTEMP, HEATER_0_MAX6675_TMIN + .01)) min_temp_error(H_E0);
@@ -3137,6 +3145,11 @@ void Temperature::tick() {
         , const bool click_to_cancel/*=false*/
       #endif
     ) {
+      #if HAS_GCODE_WAIT
+        REMEMBER(gw, planner.gcode_wait, true);   // Moves running out while heating aren't an underrun
+        planner.gcode_waits++;
+      #endif
+
       #if TEMP_RESIDENCY_TIME > 0
         millis_t residency_start_ms = 0;
         bool first_loop = true;
@@ -3260,6 +3273,11 @@ void Temperature::tick() {
         , const bool click_to_cancel/*=false*/
       #endif
     ) {
+      #if HAS_GCODE_WAIT
+        REMEMBER(gw, planner.gcode_wait, true);
+        planner.gcode_waits++;
+      #endif
+
       #if TEMP_BED_RESIDENCY_TIME > 0
         millis_t residency_start_ms = 0;
         bool first_loop = true;
@@ -3386,6 +3404,11 @@ void Temperature::tick() {
     #endif
 
     bool Temperature::wait_for_chamber(const bool no_wait_for_cooling/*=true*/) {
+      #if HAS_GCODE_WAIT
+        REMEMBER(gw, planner.gcode_wait, true);
+        planner.gcode_waits++;
+      #endif
+
       #if TEMP_CHAMBER_RESIDENCY_TIME > 0
         millis_t residency_start_ms = 0;
         bool first_loop = true;
@@ -908,6 +908,37 @@ int SdBaseFile::peek() {
   return c;
 }
 
+#if ENABLED(SD_READ_AHEAD)
+
+  /**
+   * Load the block at the current position into the volume cache so the
+   * next read() finds it there. The file position is not changed.
+   *
+   * \return true for success or false for failure.
+   */
+  bool SdBaseFile::prefetch() {
+    if (!isOpen() || !(flags_ & O_READ) || curPosition_ >= fileSize_) return true;
+
+    uint32_t block;
+    if (type_ == FAT_FILE_TYPE_ROOT_FIXED)
+      block = vol_->rootDirStart() + (curPosition_ >> 9);
+    else {
+      uint32_t cluster = curCluster_;
+      const uint8_t blockOfCluster = vol_->blockOfCluster(curPosition_);
+      if ((curPosition_ & 0x1FF) == 0 && blockOfCluster == 0) {
+        // read() will move on to the next cluster
+        if (curPosition_ == 0)
+          cluster = firstCluster_;
+        else if (!vol_->fatGet(curCluster_, &cluster))
+          return false;
+      }
+      block = vol_->clusterStartBlock(cluster) + blockOfCluster;
+    }
+    return vol_->cacheRawBlock(block, SdVolume::CACHE_FOR_READ);
+  }
+
+#endif // SD_READ_AHEAD
+
 // print uint8_t with width 2
 static void print2u(const uint8_t v) {
   if (v < 10) SERIAL_CHAR('0');
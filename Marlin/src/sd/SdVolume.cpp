@@ -181,10 +181,32 @@ bool SdVolume::fatGet(uint32_t cluster, uint32_t* value) {
   else
     return false;
 
+  #if ENABLED(SD_READ_AHEAD)
+    // Within a run of contiguous clusters found earlier?
+    if (cluster >= fatRunStart_ && cluster < fatRunEnd_) {
+      *value = cluster + 1;
+      return true;
+    }
+  #endif
+
   if (lba != cacheBlockNumber_ && !cacheRawBlock(lba, CACHE_FOR_READ))
     return false;
 
   *value = (fatType_ == 16) ? cacheBuffer_.fat16[cluster & 0xFF] : (cacheBuffer_.fat32[cluster & 0x7F] & FAT32MASK);
+
+  #if ENABLED(SD_READ_AHEAD)
+    // Find how far the chain runs on contiguously in this FAT block, so
+    // the rest of it can be followed without reading the FAT again
+    const uint16_t entries = (fatType_ == 16) ? 256 : 128;
+    uint32_t c = cluster;
+    for (uint16_t i = cluster & (entries - 1); i < entries; i++, c++) {
+      const uint32_t next = (fatType_ == 16) ? cacheBuffer_.fat16[i] : (cacheBuffer_.fat32[i] & FAT32MASK);
+      if (next != c + 1) break;
+    }
+    fatRunStart_ = cluster;
+    fatRunEnd_ = c;
+  #endif
+
   return true;
 }
 
@@ -197,6 +219,10 @@ bool SdVolume::fatPut(uint32_t cluster, uint32_t value) {
   // error if not in FAT
   if (cluster > (clusterCount_ + 1)) return false;
 
+  #if ENABLED(SD_READ_AHEAD)
+    fatRunStart_ = fatRunEnd_ = 0;  // The chain may change
+  #endif
+
   if (FAT12_SUPPORT && fatType_ == 12) {
     uint16_t index = cluster;
     index += index >> 1;
@@ -328,6 +354,9 @@ bool SdVolume::init(Sd2Card* dev, uint8_t part) {
   cacheDirty_ = 0;  // cacheFlush() will write block if true
   cacheMirrorBlock_ = 0;
   cacheBlockNumber_ = 0xFFFFFFFF;
+  #if ENABLED(SD_READ_AHEAD)
+    fatRunStart_ = fatRunEnd_ = 0;
+  #endif
 
   // if part == 0 assume super floppy with FAT boot sector in block zero
   // if part > 0 assume mbr volume with partition table
@@ -164,6 +164,11 @@ class SdVolume {
   uint16_t rootDirEntryCount_;  // number of entries in FAT16 root dir
   uint32_t rootDirStart_;       // root start block for FAT16, cluster for FAT32
 
+  #if ENABLED(SD_READ_AHEAD)
+    uint32_t fatRunStart_;      // Clusters from fatRunStart_ up to fatRunEnd_
+    uint32_t fatRunEnd_;        //  are each followed by the next cluster
+  #endif
+
   bool allocContiguous(uint32_t count, uint32_t* curCluster);
   uint8_t blockOfCluster(uint32_t position) const { return (position >> 9) & (blocksPerCluster_ - 1); }
   uint32_t clusterStartBlock(uint32_t cluster) const { return dataStartBlock_ + ((cluster - 2) << clusterSizeShift_); }
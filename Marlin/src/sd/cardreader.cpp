@@ -34,6 +34,14 @@
 #include "../gcode/queue.h"
 #include "../module/configuration_store.h"
 
+#if ENABLED(SD_COMPRESSED_GCODE)
+  #include "../libs/heatshrink/heatshrink_decoder.h"
+#endif
+
+#if ENABLED(SD_BINARY_GCODE)
+  #include "../gcode/parser.h"
+#endif
+
 #if defined(POWER_OUTAGE_TEST)
 extern unsigned char PowerTestFlag;
 extern char seekdataflag;
@@ -108,6 +116,10 @@ uint8_t CardReader::workDirDepth;
 
 #endif // SDCARD_SORT_ALPHA
 
+#if ENABLED(SD_DIR_INDEX)
+  uint16_t CardReader::dir_index[SD_DIR_INDEX_SIZE], CardReader::dir_count;
+#endif
+
 Sd2Card CardReader::sd2card;
 SdVolume CardReader::volume;
 SdFile CardReader::file;
@@ -118,6 +130,23 @@ char CardReader::proc_filenames[SD_PROCEDURE_DEPTH][MAXPATHNAMELENGTH];
 
 uint32_t CardReader::filesize, CardReader::sdpos;
 
+#if ENABLED(SD_READ_AHEAD)
+  uint8_t CardReader::ra_block[512];
+  uint16_t CardReader::ra_index, CardReader::ra_count;
+  uint32_t CardReader::ra_start;
+  bool CardReader::ra_fetched;
+#endif
+
+#if ENABLED(SD_COMPRESSED_GCODE)
+  static heatshrink_decoder gcz_decoder;
+  static uint8_t gcz_buffer[32], gcz_buffer_index, gcz_buffer_count;
+  uint32_t CardReader::gcz_index;
+#endif
+
+#if ENABLED(SD_BINARY_GCODE)
+  int32_t CardReader::move_last[XYZE];
+#endif
+
 CardReader::CardReader() {
   #if ENABLED(SDCARD_SORT_ALPHA)
     sort_count = 0;
@@ -195,9 +224,9 @@ int CardReader::countItems(SdFile dir) {
 //
 // Get file/folder info for an item by index
 //
-void CardReader::selectByIndex(SdFile dir, const uint8_t index) {
+void CardReader::selectByIndex(SdFile dir, const uint16_t index) {
   dir_t p;
-  for (uint8_t cnt = 0; dir.readDir(&p, longFilename) > 0;) {
+  for (uint16_t cnt = 0; dir.readDir(&p, longFilename) > 0;) {
     if (is_dir_or_gcode(p)) {
       if (cnt == index) {
         createFilename(filename, p);
@@ -360,6 +389,9 @@ void CardReader::printFilename() {
 
 void CardReader::mount() {
   flag.mounted = false;
+  #if ENABLED(POWER_LOSS_JOURNAL)
+    recovery.journal_block = 0; // Never write raw blocks to a card that may have changed
+  #endif
   if (root.isOpen()) root.close();
 
   if (!sd2card.init(SPI_SPEED, SDSS)
@@ -386,6 +418,9 @@ void CardReader::mount() {
 void CardReader::release() {
   endFilePrint();
   flag.mounted = false;
+  #if ENABLED(POWER_LOSS_JOURNAL)
+    recovery.journal_block = 0; // Never write raw blocks to a card that may have changed
+  #endif
 }
 
 void CardReader::openAndPrintFile(const char *name) {
@@ -464,6 +499,14 @@ void announceOpen(const uint8_t doing, const char * const path) {
   }
 }
 
+#if EITHER(SD_COMPRESSED_GCODE, SD_BINARY_GCODE)
+  // Check a DOS 8.3 filename for an uppercase 3-letter extension
+  static bool has_extension(const char * const fname, const char * const ext) {
+    const char * const dot = strrchr(fname, '.');
+    return dot && toupper(dot[1]) == ext[0] && toupper(dot[2]) == ext[1] && toupper(dot[3]) == ext[2] && !dot[4];
+  }
+#endif
+
 //
 // Open a file by DOS path for read
 // The 'subcall_type' flag indicates...
@@ -517,6 +560,22 @@ void CardReader::openFileRead(char * const path, const uint8_t subcall_type/*=0*
   if (file.open(curDir, fname, O_READ)) {
     filesize = file.fileSize();
     sdpos = 0;
+    #if ENABLED(PLANNER_UNDERRUN_STATS)
+      queue.sd_line = 0;
+    #endif
+    #if ENABLED(SD_READ_AHEAD)
+      ra_start = ra_index = ra_count = 0;
+      ra_fetched = false;
+    #endif
+
+    #if ENABLED(SD_COMPRESSED_GCODE)
+      flag.compressed = has_extension(fname, "GCZ");
+      if (flag.compressed) gcz_rewind();
+    #endif
+    #if ENABLED(SD_BINARY_GCODE)
+      flag.binary_gcode = has_extension(fname, "GCB");
+      ZERO(move_last);
+    #endif
 
     PORT_REDIRECT(SERIAL_BOTH);
     SERIAL_ECHOLNPAIR(STR_SD_FILE_OPENED, fname, STR_SD_SIZE, filesize);
@@ -530,6 +589,254 @@ void CardReader::openFileRead(char * const path, const uint8_t subcall_type/*=0*
     openFailed(fname);
 }
 
+#if ENABLED(SD_READ_AHEAD)
+
+  //
+  // Move on to the next block of the file. The file itself is only ever
+  // read in whole blocks, so the next block starts where it stands.
+  // After a seek ra_index may already point into the new block.
+  //
+  bool CardReader::ra_fill() {
+    ra_start += ra_count;
+    ra_index -= ra_count;
+    const int16_t n = file.read(ra_block, sizeof(ra_block));
+    ra_count = _MAX(n, 0);
+    ra_fetched = false;
+    return ra_index < ra_count;
+  }
+
+  int16_t CardReader::file_read(uint8_t *buf, uint16_t nbyte) {
+    uint16_t done = 0;
+    while (done < nbyte) {
+      if (ra_index >= ra_count && !ra_fill()) break;
+      const uint16_t n = _MIN(nbyte - done, ra_count - ra_index);
+      memcpy(buf + done, ra_block + ra_index, n);
+      ra_index += n;
+      done += n;
+    }
+    return done;
+  }
+
+  void CardReader::file_seek(const uint32_t pos) {
+    // Seeking within the current block needs no reading
+    if (ra_count && pos >= ra_start && pos < ra_start + ra_count) {
+      ra_index = pos - ra_start;
+      return;
+    }
+    ra_start = pos & ~0x1FFUL;
+    ra_index = pos & 0x1FF;
+    ra_count = 0;
+    ra_fetched = false;
+    file.seekSet(ra_start);
+  }
+
+  //
+  // Called from the idle loop. While a file is printing, load its next block
+  // into the volume cache so ra_fill() only has to copy it.
+  //
+  void CardReader::read_ahead() {
+    if (ra_fetched || !flag.sdprinting || !isFileOpen()) return;
+    ra_fetched = true;
+    file.prefetch();
+  }
+
+#endif // SD_READ_AHEAD
+
+#if ENABLED(SD_BATCH_READ)
+
+  //
+  // Point data at the bytes that are ready to read, loading more if needed,
+  // and return how many there are. Return 0 at the end of the file or on a
+  // read error, with sdpos set as get() would leave it.
+  //
+  uint16_t CardReader::get_span(const uint8_t* &data) {
+    #if ENABLED(SD_COMPRESSED_GCODE)
+      if (flag.compressed) {
+        if (gcz_buffer_index >= gcz_buffer_count && !gcz_fill()) { sdpos = gcz_index; return 0; }
+        data = gcz_buffer + gcz_buffer_index;
+        return gcz_buffer_count - gcz_buffer_index;
+      }
+    #endif
+    if (ra_index >= ra_count && !ra_fill()) { sdpos = file_position(); return 0; }
+    data = ra_block + ra_index;
+    return ra_count - ra_index;
+  }
+
+  //
+  // Consume n bytes of the span. Like get(), leave sdpos at the last one.
+  //
+  void CardReader::skip(const uint16_t n) {
+    #if ENABLED(SD_COMPRESSED_GCODE)
+      if (flag.compressed) {
+        gcz_buffer_index += n;
+        gcz_index += n;
+        sdpos = gcz_index - 1;
+        return;
+      }
+    #endif
+    ra_index += n;
+    sdpos = file_position() - 1;
+  }
+
+#endif // SD_BATCH_READ
+
+#if ENABLED(SD_COMPRESSED_GCODE)
+
+  //
+  // Start decoding the open .gcz file from the beginning
+  //
+  void CardReader::gcz_rewind() {
+    heatshrink_decoder_reset(&gcz_decoder);
+    file_seek(0);
+    gcz_buffer_index = gcz_buffer_count = 0;
+    gcz_index = 0;
+    flag.compressed_eof = false;
+  }
+
+  //
+  // Decode the next chunk of the .gcz file, reading from the card as needed.
+  // Return false at the end of the file or on a read error.
+  //
+  bool CardReader::gcz_fill() {
+    gcz_buffer_index = 0;
+    for (;;) {
+      size_t count;
+      heatshrink_decoder_poll(&gcz_decoder, gcz_buffer, sizeof(gcz_buffer), &count);
+      gcz_buffer_count = count;
+      if (count) return true;
+
+      // The decoder has used all its input
+      uint8_t input[HEATSHRINK_STATIC_INPUT_BUFFER_SIZE];
+      const int16_t n = file_read(input, sizeof(input));
+      if (n <= 0) {
+        if (n == 0) flag.compressed_eof = true;
+        return false;
+      }
+      heatshrink_decoder_sink(&gcz_decoder, input, n, &count);
+    }
+  }
+
+  int16_t CardReader::gcz_get() {
+    sdpos = gcz_index;
+    if (gcz_buffer_index >= gcz_buffer_count && !gcz_fill()) return -1;
+    gcz_index++;
+    return gcz_buffer[gcz_buffer_index++];
+  }
+
+  //
+  // The decoder can only go forward, so seeking back starts over
+  //
+  void CardReader::gcz_seek(const uint32_t index) {
+    if (index < gcz_index) gcz_rewind();
+    while (gcz_index < index) {
+      if (gcz_buffer_index >= gcz_buffer_count && !gcz_fill()) break;
+      const uint8_t n = _MIN(index - gcz_index, uint32_t(gcz_buffer_count - gcz_buffer_index));
+      gcz_buffer_index += n;
+      gcz_index += n;
+    }
+    sdpos = gcz_index;
+  }
+
+#endif // SD_COMPRESSED_GCODE
+
+#if ENABLED(SD_BINARY_GCODE)
+
+  bool CardReader::get_varint(uint32_t &v) {
+    v = 0;
+    for (uint8_t shift = 0; shift < 32; shift += 7) {
+      const int16_t c = get();
+      if (c < 0) return false;
+      v |= uint32_t(c & 0x7F) << shift;
+      if (!(c & 0x80)) return true;
+    }
+    return false;
+  }
+
+  static inline int32_t unzigzag(const uint32_t v) { return int32_t(v >> 1) ^ -int32_t(v & 1); }
+
+  /**
+   * Read the rest of a binary move record that starts with op and store it
+   * in cmd as parser tokens. A record is one op byte and varints:
+   *
+   *   [1 F E Z Y X g g] [X] [Y] [Z] [E] [F] [I J]
+   *
+   * 'gg' is the G-code number (0-3). X Y Z E are zigzag deltas from the
+   * previous move in µm (E in 10 nm). F is in mm/min. G2/G3 add I and J
+   * as zigzag values in µm. The converter only writes values that give
+   * the same floats as the text would, so printing is unchanged.
+   *
+   * With no cmd only the positions are updated. Return 0 on a read error.
+   */
+  uint8_t CardReader::get_move(const uint8_t op, char * const cmd) {
+    char letters[7];
+    float values[7];
+    uint8_t count = 0;
+    uint32_t v;
+
+    LOOP_XYZE(i) if (TEST(op, 2 + i)) {
+      if (!get_varint(v)) return 0;
+      move_last[i] += unzigzag(v);
+      letters[count] = axis_codes[i];
+      values[count++] = float(move_last[i]) / (i == E_AXIS ? 100000.0f : 1000.0f);
+    }
+    if (TEST(op, 6)) {
+      if (!get_varint(v)) return 0;
+      letters[count] = 'F';
+      values[count++] = float(v);
+    }
+    if (op & 2) for (char c = 'I'; c <= 'J'; ++c) {
+      if (!get_varint(v)) return 0;
+      letters[count] = c;
+      values[count++] = float(unzigzag(v)) / 1000.0f;
+    }
+
+    return cmd ? parser.tokenize_move(cmd, op & 3, letters, values, count) : 1;
+  }
+
+#endif // SD_BINARY_GCODE
+
+#if EITHER(SD_BINARY_GCODE, PLANNER_UNDERRUN_STATS)
+
+  /**
+   * Binary moves are relative to the previous move, so replay the file
+   * up to the new position to know the positions there. That also counts
+   * the lines up to there for M941. Other files count lines from the new
+   * position on.
+   */
+  void CardReader::setIndex(const uint32_t index) {
+    #if ENABLED(PLANNER_UNDERRUN_STATS)
+      queue.sd_line = 0;
+    #endif
+
+    #if ENABLED(SD_BINARY_GCODE)
+      if (flag.binary_gcode) {
+        seekIndex(0);
+        ZERO(move_last);
+        bool line_start = true;
+        for (uint32_t next = 0; next < index; next = sdpos + 1) {
+          const int16_t c = get();
+          if (c < 0) break;
+          if (line_start && c >= 0x80) {
+            if (!get_move(c, nullptr)) break;
+            #if ENABLED(PLANNER_UNDERRUN_STATS)
+              queue.sd_line++;                        // A record stands for a line
+            #endif
+          }
+          else {
+            line_start = c == '\n' || c == '\r';
+            #if ENABLED(PLANNER_UNDERRUN_STATS)
+              if (c == '\n') queue.sd_line++;
+            #endif
+          }
+        }
+      }
+    #endif
+
+    seekIndex(index);
+  }
+
+#endif
+
 inline void echo_write_to_file(const char * const fname) {
   SERIAL_ECHOLNPAIR(STR_SD_WRITE_TO_FILE, fname);
 }
@@ -549,6 +856,10 @@ void CardReader::openFileWrite(char * const path) {
   const char * const fname = diveToFile(false, curDir, path);
   if (!fname) return;
 
+  #if ENABLED(SD_DIR_INDEX)
+    flush_dir_index();                              // A new entry may be added
+  #endif
+
   if (file.open(curDir, fname, O_CREAT | O_APPEND | O_WRITE | O_TRUNC)) {
     flag.saving = true;
     selectFileByName(fname);
@@ -577,6 +888,9 @@ void CardReader::removeFile(const char * const name) {
   if (file.remove(curDir, fname)) {
     SERIAL_ECHOLNPAIR("File deleted:", fname);
     sdpos = 0;
+    #if ENABLED(SD_DIR_INDEX)
+      flush_dir_index();
+    #endif
     #if ENABLED(SDCARD_SORT_ALPHA)
       presort();
     #endif
@@ -588,7 +902,7 @@ void CardReader::removeFile(const char * const name) {
 void CardReader::report_status() {
   if (isPrinting()) {
     SERIAL_ECHOPGM(STR_SD_PRINTING_BYTE);
-    SERIAL_ECHO(sdpos);
+    SERIAL_ECHO(readIndex());
     SERIAL_CHAR('/');
     SERIAL_ECHOLN(filesize);
   }
@@ -683,6 +997,15 @@ void CardReader::selectFileByIndex(const uint16_t nr) {
       return;
     }
   #endif
+  #if ENABLED(SD_DIR_INDEX)
+    if (!flag.dir_indexed) build_dir_index();
+    if (nr < dir_count) {
+      // Start at the item, or at the last indexed item before it
+      const uint16_t i = _MIN(nr, uint16_t(SD_DIR_INDEX_SIZE - 1));
+      workDir.seekSet(uint32_t(dir_index[i]) << 5);
+      return selectByIndex(workDir, nr - i);
+    }
+  #endif
   workDir.rewind();
   selectByIndex(workDir, nr);
 }
@@ -705,10 +1028,35 @@ void CardReader::selectFileByName(const char * const match) {
 }
 
 uint16_t CardReader::countFilesInWorkDir() {
-  workDir.rewind();
-  return countItems(workDir);
+  #if ENABLED(SD_DIR_INDEX)
+    if (!flag.dir_indexed) build_dir_index();
+    return dir_count;
+  #else
+    workDir.rewind();
+    return countItems(workDir);
+  #endif
 }
 
+#if ENABLED(SD_DIR_INDEX)
+
+  //
+  // Read the working directory once, noting where each item starts.
+  // readDir() from that position gets the item with its long name.
+  //
+  void CardReader::build_dir_index() {
+    dir_t p;
+    dir_count = 0;
+    workDir.rewind();
+    for (uint32_t pos = 0; workDir.readDir(&p, longFilename) > 0; pos = workDir.curPosition()) {
+      if (!is_dir_or_gcode(p)) continue;
+      if (dir_count < SD_DIR_INDEX_SIZE) dir_index[dir_count] = pos >> 5;
+      dir_count++;
+    }
+    flag.dir_indexed = true;
+  }
+
+#endif
+
 /**
  * Dive to the given DOS 8.3 file path, with optional echo of the dive paths.
  *
@@ -784,6 +1132,9 @@ void CardReader::cd(const char * relpath) {
   if (newDir.open(parent, relpath, O_READ)) {
     workDir = newDir;
     flag.workDirIsRoot = false;
+    #if ENABLED(SD_DIR_INDEX)
+      flush_dir_index();
+    #endif
     if (workDirDepth < MAX_DIR_DEPTH)
       workDirParents[workDirDepth++] = workDir;
     #if ENABLED(SDCARD_SORT_ALPHA)
@@ -799,6 +1150,9 @@ void CardReader::cd(const char * relpath) {
 int8_t CardReader::cdup() {
   if (workDirDepth > 0) {                                               // At least 1 dir has been saved
     workDir = --workDirDepth ? workDirParents[workDirDepth - 1] : root; // Use parent, or root if none
+    #if ENABLED(SD_DIR_INDEX)
+      flush_dir_index();
+    #endif
     #if ENABLED(SDCARD_SORT_ALPHA)
       presort();
     #endif
@@ -810,6 +1164,9 @@ int8_t CardReader::cdup() {
 void CardReader::cdroot() {
   workDir = root;
   flag.workDirIsRoot = true;
+  #if ENABLED(SD_DIR_INDEX)
+    flush_dir_index();
+  #endif
   #if ENABLED(SDCARD_SORT_ALPHA)
     presort();
   #endif
@@ -1125,12 +1482,71 @@ void CardReader::fileHasFinished() {
   void CardReader::openJobRecoveryFile(const bool read) {
     if (!isMounted()) return;
     if (recovery.file.isOpen()) return;
+    #if ENABLED(SD_DIR_INDEX)
+      if (!read) flush_dir_index();
+    #endif
     if (!recovery.file.open(&root, recovery.filename, read ? O_READ : O_CREAT | O_WRITE | O_TRUNC | O_SYNC))
       SERIAL_ECHOLNPAIR(STR_SD_OPEN_FILE_FAIL, recovery.filename, ".");
     else if (!read)
       echo_write_to_file(recovery.filename);
   }
 
+  #if ENABLED(POWER_LOSS_JOURNAL)
+
+    //
+    // Open the recovery file as a journal of POWER_LOSS_JOURNAL_BLOCKS
+    // contiguous blocks, creating it (zeroed) if it isn't one already.
+    // Return the first block on the card, or 0 on failure. The file is
+    // left open for reading.
+    //
+    uint32_t CardReader::openJobRecoveryJournal() {
+      constexpr uint32_t size = uint32_t(POWER_LOSS_JOURNAL_BLOCKS) * 512;
+      uint32_t first, last;
+      if (!isMounted()) return 0;
+      if (recovery.file.isOpen()) recovery.file.close();
+
+      if (recovery.file.open(&root, recovery.filename, O_READ)) {
+        if (recovery.file.fileSize() == size && recovery.file.contiguousRange(&first, &last))
+          return first;
+        // An old-style or damaged file is replaced. Delete it quietly,
+        // without the file list side effects of removeFile().
+        recovery.file.close();
+        SdFile::remove(&root, recovery.filename);
+      }
+
+      #if ENABLED(SD_DIR_INDEX)
+        flush_dir_index();
+      #endif
+      if (!recovery.file.createContiguous(&root, recovery.filename, size) || !recovery.file.contiguousRange(&first, &last)) {
+        SERIAL_ECHOLNPAIR(STR_SD_OPEN_FILE_FAIL, recovery.filename, ".");
+        return 0;
+      }
+      // Clear out whatever the clusters held before
+      for (uint8_t i = 0; i < POWER_LOSS_JOURNAL_BLOCKS; i++)
+        if (!writeJobRecoveryBlock(first + i, nullptr, 0)) {
+          recovery.file.close();
+          return 0;
+        }
+      return first;
+    }
+
+    //
+    // Write a journal record straight to its block, through the volume cache
+    // so no other block buffer is needed. The rest of the block is zeroed.
+    //
+    bool CardReader::writeJobRecoveryBlock(const uint32_t block, const void * const data, const uint16_t len) {
+      cache_t * const cache = volume.cacheClear();
+      if (!cache) return false;
+      #if ENABLED(SD_READ_AHEAD)
+        ra_fetched = false; // The next block of the print has to be fetched again
+      #endif
+      if (len) memcpy(cache->data, data, len);
+      memset(cache->data + len, 0, 512 - len);
+      return sd2card.writeBlock(block, cache->data);
+    }
+
+  #endif // POWER_LOSS_JOURNAL
+
   // Removing the job recovery file currently requires closing
   // the file being printed, so during SD printing the file should
   // be zeroed and written instead of deleted.
@@ -44,6 +44,16 @@ typedef struct {
        #if ENABLED(BINARY_FILE_TRANSFER)
          , binary_mode:1
        #endif
+       #if ENABLED(SD_COMPRESSED_GCODE)
+         , compressed:1                             // Open file is a heatshrink-compressed .gcz
+         , compressed_eof:1                         // All of the .gcz file has been decoded
+       #endif
+       #if ENABLED(SD_BINARY_GCODE)
+         , binary_gcode:1                           // Open file is a .gcb with binary move records
+       #endif
+       #if ENABLED(SD_DIR_INDEX)
+         , dir_indexed:1                            // The working directory index is up to date
+       #endif
     ;
 } card_flags_t;
 
@@ -120,9 +130,9 @@ public:
   static inline bool isPaused() { return isFileOpen() && !flag.sdprinting; }
   static inline bool isPrinting() { return flag.sdprinting; }
   #if HAS_PRINT_PROGRESS_PERMYRIAD
-    static inline uint16_t permyriadDone() { return (isFileOpen() && filesize) ? sdpos / ((filesize + 9999) / 10000) : 0; }
+    static inline uint16_t permyriadDone() { return (isFileOpen() && filesize) ? readIndex() / ((filesize + 9999) / 10000) : 0; }
   #endif
-  static inline uint8_t percentDone() { return (isFileOpen() && filesize) ? sdpos / ((filesize + 99) / 100) : 0; }
+  static inline uint8_t percentDone() { return (isFileOpen() && filesize) ? readIndex() / ((filesize + 99) / 100) : 0; }
 
   // Helper for open and remove
   static const char* diveToFile(const bool update_cwd, SdFile*& curDir, const char * const path, const bool echo=false);
@@ -143,14 +153,41 @@ public:
     static bool jobRecoverFileExists();
     static void openJobRecoveryFile(const bool read);
     static void removeJobRecoveryFile();
+    #if ENABLED(POWER_LOSS_JOURNAL)
+      static uint32_t openJobRecoveryJournal();
+      static bool writeJobRecoveryBlock(const uint32_t block, const void * const data, const uint16_t len);
+    #endif
   #endif
 
   static inline bool isFileOpen() { return isMounted() && file.isOpen(); }
   static inline uint32_t getIndex() { return sdpos; }
-  static inline bool eof() { return sdpos >= filesize; }
-  static inline void setIndex(const uint32_t index) { sdpos = index; file.seekSet(index); }
+  #if ENABLED(SD_COMPRESSED_GCODE)
+    // A .gcz file is indexed by its decoded content, but progress is measured in file bytes
+    static inline uint32_t readIndex() { return flag.compressed ? file_position() : sdpos; }
+    static inline bool eof() { return flag.compressed ? flag.compressed_eof : sdpos >= filesize; }
+    static inline int16_t get() { if (flag.compressed) return gcz_get(); sdpos = file_position(); return file_get(); }
+  #else
+    static inline uint32_t readIndex() { return sdpos; }
+    static inline bool eof() { return sdpos >= filesize; }
+    static inline int16_t get() { sdpos = file_position(); return file_get(); }
+  #endif
+  #if ENABLED(SD_READ_AHEAD)
+    static void read_ahead();
+  #endif
+  #if ENABLED(SD_BATCH_READ)
+    // Buffered bytes of the file being printed, used in place with skip() instead of get()
+    static uint16_t get_span(const uint8_t* &data);
+    static void skip(const uint16_t n);
+  #endif
+  #if EITHER(SD_BINARY_GCODE, PLANNER_UNDERRUN_STATS)
+    static void setIndex(const uint32_t index);
+  #else
+    static inline void setIndex(const uint32_t index) { seekIndex(index); }
+  #endif
+  #if ENABLED(SD_BINARY_GCODE)
+    static uint8_t get_move(const uint8_t op, char * const cmd);
+  #endif
   static inline char* getWorkDirName() { workDir.getDosName(filename); return filename; }
-  static inline int16_t get() { sdpos = file.curPosition(); return (int16_t)file.read(); }
   static inline int16_t read(void* buf, uint16_t nbyte) { return file.isOpen() ? file.read(buf, nbyte) : -1; }
   static inline int16_t write(void* buf, uint16_t nbyte) { return file.isOpen() ? file.write(buf, nbyte) : -1; }
   static inline long GetLastSDpos() { return sdpos; };
@@ -238,6 +275,51 @@ private:
 
   static uint32_t filesize, sdpos;
 
+  //
+  // Reading the file being printed
+  //
+  #if ENABLED(SD_READ_AHEAD)
+    static uint8_t ra_block[512];                   // The block being read
+    static uint16_t ra_index, ra_count;             // Read position and valid bytes in ra_block
+    static uint32_t ra_start;                       // File position of ra_block[0]
+    static bool ra_fetched;                         // The next block is in the volume cache
+    static bool ra_fill();
+    static inline uint32_t file_position() { return ra_start + ra_index; }
+    static inline int16_t file_get() { return (ra_index < ra_count || ra_fill()) ? ra_block[ra_index++] : -1; }
+    static int16_t file_read(uint8_t *buf, uint16_t nbyte);
+    static void file_seek(const uint32_t pos);
+  #else
+    static inline uint32_t file_position() { return file.curPosition(); }
+    static inline int16_t file_get() { return (int16_t)file.read(); }
+    static inline int16_t file_read(uint8_t *buf, const uint16_t nbyte) { return file.read(buf, nbyte); }
+    static inline void file_seek(const uint32_t pos) { file.seekSet(pos); }
+  #endif
+
+  //
+  // Compressed G-code files
+  //
+  #if ENABLED(SD_COMPRESSED_GCODE)
+    static uint32_t gcz_index;                      // Decoded bytes returned so far
+    static bool gcz_fill();
+    static void gcz_rewind();
+    static int16_t gcz_get();
+    static void gcz_seek(const uint32_t index);
+  #endif
+
+  #if ENABLED(SD_COMPRESSED_GCODE)
+    static inline void seekIndex(const uint32_t index) { if (flag.compressed) gcz_seek(index); else { sdpos = index; file_seek(index); } }
+  #else
+    static inline void seekIndex(const uint32_t index) { sdpos = index; file_seek(index); }
+  #endif
+
+  //
+  // Binary G-code files
+  //
+  #if ENABLED(SD_BINARY_GCODE)
+    static int32_t move_last[XYZE];                 // Positions of the previous binary move, in file units
+    static bool get_varint(uint32_t &v);
+  #endif
+
   //
   // Procedure calls to other files
   //
@@ -264,13 +346,23 @@ private:
   //
   static bool is_dir_or_gcode(const dir_t &p);
   static int countItems(SdFile dir);
-  static void selectByIndex(SdFile dir, const uint8_t index);
+  static void selectByIndex(SdFile dir, const uint16_t index);
   static void selectByName(SdFile dir, const char * const match);
   static void printListing(SdFile parent, const char * const prepend=nullptr);
 
   #if ENABLED(SDCARD_SORT_ALPHA)
     static void flush_presort();
   #endif
+
+  //
+  // Positions of the items in the working directory
+  //
+  #if ENABLED(SD_DIR_INDEX)
+    static uint16_t dir_index[SD_DIR_INDEX_SIZE];   // Directory entry where each item starts
+    static uint16_t dir_count;                      // Items in the working directory
+    static void build_dir_index();
+    static inline void flush_dir_index() { flag.dir_indexed = false; }
+  #endif
 };
 
 #if ENABLED(USB_FLASH_DRIVE_SUPPORT)
@@ -0,0 +1,236 @@
+#!/usr/bin/env python
+
+from __future__ import print_function
+from __future__ import division
+
+""" Host test for PLANNER_FIXED_POINT. Builds the kernels in
+    Marlin/src/libs/fixed_point.h with the host compiler and checks them on
+    random input against the planner's float math done in double precision:
+    the trapezoid of calculate_trapezoid_float(), the entry and exit rates of
+    recalculate_trapezoids(), the square root for block->millimeters and the
+    junction acceleration limit. The same math in single precision, as the
+    planner gets on AVR, is listed alongside. Also times both on the host. """
+
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+parser = argparse.ArgumentParser(description=__doc__)
+parser.add_argument('-n', '--blocks', type=int, default=1000000, help='random blocks to check (default=1000000)')
+parser.add_argument('-s', '--seed', type=int, default=1, help='random seed (default=1)')
+parser.add_argument('--cxx', default=os.environ.get('CXX', 'g++'), help='host C++ compiler (default=$CXX or g++)')
+args = parser.parse_args()
+
+LIBS = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', '..', 'Marlin', 'src', 'libs')
+
+HARNESS = r'''
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "fixed_point.h"
+
+struct block { uint32_t count, initial, nominal, final_, accel, inverse; uint8_t shift; };
+struct result { uint32_t until, after, cruise; };
+
+// Planner::calculate_trapezoid_float, with the planner.h helpers written out.
+// Single precision is what the planner gets on AVR. Double is the exact reference.
+template<typename T>
+static result trapezoid_float(const block &b) {
+  const T vi = b.initial, vn = b.nominal, vf = b.final_, a = b.accel;
+  uint32_t accelerate_steps = std::ceil((vn * vn - vi * vi) / (a * 2)),
+           decelerate_steps = std::floor((vf * vf - vn * vn) / (-a * 2));
+  int32_t plateau_steps = b.count - accelerate_steps - decelerate_steps;
+  uint32_t cruise = b.nominal;
+  if (plateau_steps < 0) {
+    const T s = std::ceil((a * 2 * b.count - vi * vi + vf * vf) / (a * 4));
+    accelerate_steps = s > 0 ? uint32_t(s) : 0;
+    if (accelerate_steps > b.count) accelerate_steps = b.count;
+    plateau_steps = 0;
+    cruise = std::sqrt(vi * vi + 2 * a * accelerate_steps);
+  }
+  return { accelerate_steps, accelerate_steps + plateau_steps, cruise };
+}
+
+static result trapezoid_fixed(const block &b) {
+  const fp_trapezoid_t t = fp_trapezoid(b.count, b.initial, b.nominal, b.final_, b.accel, b.inverse, b.shift, true);
+  return { t.accelerate_steps, t.accelerate_steps + t.plateau_steps, t.cruise_rate };
+}
+
+static uint32_t diff(const uint32_t x, const uint32_t y) { return x > y ? x - y : y - x; }
+
+// Entry and exit rates. The float path scales the nominal rate by the speed ratio,
+// Planner::rate_for_speed_sqr takes the root of the squared speed times (steps/mm)^2.
+struct move { float speed_sqr, nominal_speed_sqr, steps_per_mm_sqr; uint32_t nominal_rate; double exact; };
+
+static uint32_t rate_float(const move &m) {
+  return std::ceil(m.nominal_rate * (std::sqrt(m.speed_sqr) * (1.0f / std::sqrt(m.nominal_speed_sqr))));
+}
+static uint32_t rate_fixed(const move &m) { return fp_sqrt_ceil(m.speed_sqr * m.steps_per_mm_sqr); }
+
+// Planner::limit_value_by_axis_maximum
+struct junction { float limit, unit[4], max[4], inverse[4]; };
+
+static float limit_float(const junction &j) {
+  float limit = j.limit;
+  for (int i = 0; i < 4; i++) if (j.unit[i]) limit = std::min(limit, std::fabs(j.max[i] / j.unit[i]));
+  return limit;
+}
+static float limit_fixed(const junction &j) { return fp_limit_by_axes(j.limit, j.unit, j.inverse, 4); }
+static double limit_exact(const junction &j) {
+  double limit = j.limit;
+  for (int i = 0; i < 4; i++) if (j.unit[i]) limit = std::min(limit, std::fabs(double(j.max[i]) / j.unit[i]));
+  return limit;
+}
+
+static float sqrt_float(const float v) { return std::sqrt(v); }
+
+int main(int argc, char **argv) {
+  const long n = atol(argv[1]);
+  std::mt19937 rng(atol(argv[2]));
+  auto log_uniform = [&](const double lo, const double hi) {
+    return uint32_t(exp(std::uniform_real_distribution<double>(log(lo), log(hi))(rng)));
+  };
+  auto fraction = [&]() { return std::uniform_real_distribution<double>(0, 1)(rng); };
+
+  // Rates from MINIMAL_STEP_RATE to the 16-bit limit, accelerations
+  // from 100 steps/s^2 to 3000mm/s^2 at 400 steps/mm
+  std::vector<block> blocks(n);
+  for (block &b : blocks) {
+    b.count = log_uniform(1, 200000);
+    b.nominal = log_uniform(120, 65535);
+    b.initial = 120 + uint32_t((b.nominal - 120) * fraction());
+    b.final_ = 120 + uint32_t((b.nominal - 120) * fraction());
+    b.accel = log_uniform(100, 1200000);
+    b.inverse = fp_inverse_2x(b.accel, b.shift);
+  }
+
+  struct error { long differ; uint32_t steps, rate; } err_float = { 0, 0, 0 }, err_fixed = { 0, 0, 0 };
+  auto compare = [](error &e, const result &r, const result &ref) {
+    const uint32_t steps = diff(r.until, ref.until) > diff(r.after, ref.after) ? diff(r.until, ref.until) : diff(r.after, ref.after);
+    if (steps) e.differ++;
+    if (steps > e.steps) e.steps = steps;
+    if (diff(r.cruise, ref.cruise) > e.rate) e.rate = diff(r.cruise, ref.cruise);
+  };
+  long checked = 0;
+  for (const block &b : blocks) {
+    const result f = trapezoid_float<float>(b);
+    if (f.after > b.count) continue;  // The float path wraps. PLANNER_FIXED_POINT_CHECK skips these too.
+    checked++;
+    const result exact = trapezoid_float<double>(b);
+    compare(err_float, f, exact);
+    compare(err_fixed, trapezoid_fixed(b), exact);
+  }
+  printf("Blocks checked:%ld (%ld skipped where the float path wraps)\n", checked, n - checked);
+  printf("Trapezoid against double precision:\n");
+  printf("  float: blocks with other step indices:%ld, max %u steps, max cruise rate error %u steps/s\n", err_float.differ, err_float.steps, err_float.rate);
+  printf("  fixed: blocks with other step indices:%ld, max %u steps, max cruise rate error %u steps/s\n", err_fixed.differ, err_fixed.steps, err_fixed.rate);
+
+  typedef std::chrono::steady_clock clk;
+  volatile uint32_t sink = 0;
+  auto time = [&](result (*fn)(const block &)) {
+    const auto t0 = clk::now();
+    for (const block &b : blocks) sink = sink + fn(b).after;
+    return std::chrono::duration<double, std::nano>(clk::now() - t0).count() / n;
+  };
+  const double t_float = time(trapezoid_float<float>), t_fixed = time(trapezoid_fixed);
+  printf("  Host time per block: float %.1fns, fixed %.1fns\n", t_float, t_fixed);
+
+  // Entry and exit rates of blocks up to 65535 steps/s, the way _populate_block sets them up
+  std::vector<move> moves;
+  while (long(moves.size()) < n) {
+    const uint32_t count = log_uniform(1, 200000);
+    const float mm = count / float(log_uniform(5, 3200)), inverse_secs = float(log_uniform(1, 500)) / mm;
+    move m;
+    m.nominal_rate = std::ceil(count * inverse_secs);
+    if (m.nominal_rate > 65535) continue;
+    m.nominal_speed_sqr = (mm * inverse_secs) * (mm * inverse_secs);
+    m.steps_per_mm_sqr = (count * (1.0f / mm)) * (count * (1.0f / mm));
+    m.speed_sqr = m.nominal_speed_sqr * fraction() * 1.5;  // Exit speeds can be over the nominal speed
+    if (m.speed_sqr * m.steps_per_mm_sqr >= 65535.0f * 65535.0f) continue;  // The planner takes the float root here
+    m.exact = std::ceil(double(count) / mm * std::sqrt(double(m.speed_sqr)));
+    moves.push_back(m);
+  }
+  uint32_t rate_err_float = 0, rate_err_fixed = 0;
+  for (const move &m : moves) {
+    rate_err_float = std::max(rate_err_float, diff(rate_float(m), m.exact));
+    rate_err_fixed = std::max(rate_err_fixed, diff(rate_fixed(m), m.exact));
+  }
+  auto time_rate = [&](uint32_t (*fn)(const move &)) {
+    const auto t0 = clk::now();
+    for (const move &m : moves) sink = sink + fn(m);
+    return std::chrono::duration<double, std::nano>(clk::now() - t0).count() / n;
+  };
+  const double t_rate_float = time_rate(rate_float), t_rate_fixed = time_rate(rate_fixed);
+  printf("Entry and exit rates: max error float %u, fixed %u steps/s\n", rate_err_float, rate_err_fixed);
+  printf("  Host time per rate: float %.1fns, fixed %.1fns\n", t_rate_float, t_rate_fixed);
+
+  // Square roots across the range of squared move lengths in mm^2
+  std::vector<float> squares(n);
+  for (float &v : squares) v = exp(std::uniform_real_distribution<double>(log(1e-8), log(1e8))(rng));
+  double sqrt_err = 0;
+  for (const float v : squares) sqrt_err = std::max(sqrt_err, std::fabs(fp_sqrtf(v) / std::sqrt(double(v)) - 1));
+  bool sqrt_exact = fp_sqrtf(0) == 0;
+  for (uint32_t i = 1; i <= 4096; i++) sqrt_exact &= fp_sqrtf(float(i) * i) == i;
+  auto time_sqrt = [&](float (*fn)(float)) {
+    const auto t0 = clk::now();
+    for (const float v : squares) sink = sink + uint32_t(fn(v));
+    return std::chrono::duration<double, std::nano>(clk::now() - t0).count() / n;
+  };
+  const double t_sqrt_float = time_sqrt(sqrt_float), t_sqrt_fixed = time_sqrt(fp_sqrtf);
+  printf("Square root: max error fixed %.1f ppm, %s on perfect squares\n", sqrt_err * 1e6, sqrt_exact ? "exact" : "NOT exact");
+  printf("  Host time per root: float %.1fns, fixed %.1fns\n", t_sqrt_float, t_sqrt_fixed);
+
+  // Junction limits with unit vectors of 1 to 4 axes
+  std::vector<junction> junctions(n);
+  for (junction &j : junctions) {
+    j.limit = log_uniform(100, 10000);
+    float mag = 0;
+    for (int i = 0; i < 4; i++) {
+      j.unit[i] = fraction() < 0.3 ? 0 : float(fraction() * 2 - 1);
+      mag += j.unit[i] * j.unit[i];
+      j.max[i] = log_uniform(100, 10000);
+      j.inverse[i] = 1.0f / j.max[i];
+    }
+    if (mag) for (float &u : j.unit) u /= std::sqrt(mag);
+  }
+  double limit_err_float = 0, limit_err_fixed = 0;
+  for (const junction &j : junctions) {
+    const double exact = limit_exact(j);
+    limit_err_float = std::max(limit_err_float, std::fabs(limit_float(j) / exact - 1));
+    limit_err_fixed = std::max(limit_err_fixed, std::fabs(limit_fixed(j) / exact - 1));
+  }
+  auto time_limit = [&](float (*fn)(const junction &)) {
+    const auto t0 = clk::now();
+    for (const junction &j : junctions) sink = sink + uint32_t(fn(j));
+    return std::chrono::duration<double, std::nano>(clk::now() - t0).count() / n;
+  };
+  const double t_limit_float = time_limit(limit_float), t_limit_fixed = time_limit(limit_fixed);
+  printf("Junction limit: max error float %.2f ppm, fixed %.2f ppm\n", limit_err_float * 1e6, limit_err_fixed * 1e6);
+  printf("  Host time per limit: float %.1fns, fixed %.1fns\n", t_limit_float, t_limit_fixed);
+  printf("This host has an FPU, so the times only compare the two on it. AVR has none.\n");
+
+  // Fail if the trapezoid is off by more than a step or worse than single precision float,
+  // a rate is off by more than 1 step/s, a root by more than 16 ppm or a limit by more than 1 ppm
+  return err_fixed.steps > 1 || err_fixed.rate > err_float.rate
+      || rate_err_fixed > 1
+      || sqrt_err > 16e-6 || !sqrt_exact
+      || limit_err_fixed > 1e-6;
+}
+'''
+
+work = tempfile.mkdtemp(prefix='marlin_fp_')
+try:
+    src, exe = os.path.join(work, 'fixed_point_test.cpp'), os.path.join(work, 'fixed_point_test')
+    with open(src, 'w') as f:
+        f.write(HARNESS)
+    subprocess.check_call([args.cxx, '-std=c++11', '-O2', '-ffp-contract=off', '-I', LIBS, src, '-o', exe])
+    sys.exit(subprocess.call([exe, str(args.blocks), str(args.seed)]))
+finally:
+    shutil.rmtree(work)
@@ -0,0 +1,316 @@
+#!/usr/bin/env python
+
+from __future__ import print_function
+from __future__ import division
+
+""" Convert G-code to the binary .gcb format that Marlin prints with
+    SD_BINARY_GCODE enabled, or back to G-code with --decompile.
+
+    G0-G3 moves become records of one op byte and varints:
+
+      [1 F E Z Y X g g] [X] [Y] [Z] [E] [F] [I J]
+
+    'gg' is the G-code number. X Y Z E are zigzag deltas from the previous
+    record in um (E in 10 nm), F is in whole mm/min, and G2/G3 records end
+    with I and J as zigzag values in um. A move is only converted if the
+    firmware will get exactly the float it would parse from the text.
+    All other lines stay text, with comments and blank lines removed.
+
+    Every conversion is checked by decoding it again. --test runs the
+    round-trip checks on a built-in set of edge cases. """
+
+import argparse
+import os
+import re
+import struct
+import sys
+from fractions import Fraction
+
+SCALE = { 'X': 1000, 'Y': 1000, 'Z': 1000, 'E': 100000, 'F': 1, 'I': 1000, 'J': 1000 }
+AXES = 'XYZE'
+
+MOVE = re.compile(r'G([0-3])(?![0-9.])')
+PARAM = re.compile(r'\s*([A-Z])\s*([-+]?(?:[0-9]+\.?[0-9]*|\.[0-9]+))(?=[\sA-Z]|$)')
+
+#
+# Single-precision arithmetic as done by the firmware
+#
+
+def f32(x):
+    return struct.unpack('<f', struct.pack('<f', x))[0]
+
+def f32_step(x, d):
+    # The next float after x, towards +inf (d=1) or -inf (d=-1)
+    if x == 0:
+        return d * struct.unpack('<f', struct.pack('<I', 1))[0]
+    i = struct.unpack('<I', struct.pack('<f', x))[0]
+    i += d if x > 0 else -d
+    return struct.unpack('<f', struct.pack('<I', i))[0]
+
+def is_nearest_f32(f, exact):
+    # True if f is the float closest to the exact value, as strtof returns
+    err = abs(Fraction(f) - exact)
+    return all(abs(Fraction(f32_step(f, d)) - exact) >= err for d in (1, -1))
+
+def firmware_float(letter, units):
+    # float(units) / scale, both rounded to single precision (see CardReader::get_move)
+    return f32(f32(units) / SCALE[letter])
+
+#
+# Move records
+#
+
+def parse_move(line):
+    """ Split a G0-G3 line into (code, [(letter, text), ...]) or return None """
+    m = MOVE.match(line)
+    if not m:
+        return None
+    code, rest, params = int(m.group(1)), line[m.end():], []
+    while rest.strip():
+        p = PARAM.match(rest)
+        if not p:
+            return None
+        params.append((p.group(1), p.group(2)))
+        rest = rest[p.end():]
+    return code, params
+
+def encodable(code, params):
+    """ Return {letter: units} if the move fits a record, else None """
+    letters = [l for l, _ in params]
+    allowed = 'XYZEF' + ('IJ' if code >= 2 else '')
+    if len(set(letters)) != len(letters) or any(l not in allowed for l in letters):
+        return None
+    if code >= 2 and not ('I' in letters and 'J' in letters):
+        return None
+    units = {}
+    for letter, text in params:
+        exact = Fraction(text)
+        u = exact * SCALE[letter]
+        if u.denominator != 1:
+            return None
+        u = int(u)
+        if letter == 'F':
+            if not 0 <= u < (1 << 24):
+                return None
+        elif abs(u) >= (1 << 30) or not is_nearest_f32(firmware_float(letter, u), exact):
+            return None
+        units[letter] = u
+    return units
+
+def put_varint(out, v):
+    while True:
+        b = v & 0x7F
+        v >>= 7
+        if v:
+            out.append(b | 0x80)
+        else:
+            out.append(b)
+            return
+
+def zigzag(v):
+    return v * 2 if v >= 0 else -v * 2 - 1
+
+def unzigzag(v):
+    return (v >> 1) ^ -(v & 1)
+
+def compile_gcode(text):
+    out = bytearray()
+    last = dict.fromkeys(AXES, 0)
+    for raw in text.splitlines():
+        line = raw.split(';', 1)[0].strip()
+        if not line:
+            continue
+        move = parse_move(line)
+        units = encodable(*move) if move else None
+        if units is None:
+            if ord(line[0]) >= 0x80:
+                raise ValueError("line can't start with a non-ASCII character: " + raw)
+            out.extend(line.encode('latin-1') + b'\n')
+            continue
+        code = move[0]
+        op = 0x80 | code
+        for bit, letter in enumerate('XYZEF'):
+            if letter in units:
+                op |= 1 << (bit + 2)
+        out.append(op)
+        for letter in AXES:
+            if letter in units:
+                put_varint(out, zigzag(units[letter] - last[letter]))
+                last[letter] = units[letter]
+        if 'F' in units:
+            put_varint(out, units['F'])
+        if code >= 2:
+            for letter in 'IJ':
+                put_varint(out, zigzag(units[letter]))
+    return bytes(out)
+
+def read_records(data):
+    """ Yield ('text', line) or ('move', code, [(letter, units), ...]) """
+    data = bytearray(data)
+    last = dict.fromkeys(AXES, 0)
+    pos = [0]
+
+    def varint():
+        v, shift = 0, 0
+        while True:
+            if pos[0] >= len(data):
+                raise ValueError("truncated record")
+            c = data[pos[0]]
+            pos[0] += 1
+            v |= (c & 0x7F) << shift
+            shift += 7
+            if not c & 0x80:
+                return v
+
+    while pos[0] < len(data):
+        op = data[pos[0]]
+        if op < 0x80:
+            end = data.find(b'\n', pos[0])
+            end = len(data) if end < 0 else end
+            yield ('text', data[pos[0]:end].decode('latin-1'))
+            pos[0] = end + 1
+            continue
+        pos[0] += 1
+        params = []
+        for bit, letter in enumerate(AXES):
+            if op & (1 << (bit + 2)):
+                last[letter] += unzigzag(varint())
+                params.append((letter, last[letter]))
+        if op & 0x40:
+            params.append(('F', varint()))
+        if op & 2:
+            for letter in 'IJ':
+                params.append((letter, unzigzag(varint())))
+        yield ('move', op & 3, params)
+
+def format_units(letter, units):
+    scale = SCALE[letter]
+    whole, frac = divmod(abs(units), scale)
+    s = '%d' % whole
+    if frac:
+        s += ('.%0*d' % (len(str(scale)) - 1, frac)).rstrip('0')
+    return ('-' if units < 0 else '') + s
+
+def decompile_gcode(data):
+    lines = []
+    for rec in read_records(data):
+        if rec[0] == 'text':
+            lines.append(rec[1])
+        else:
+            lines.append('G%d' % rec[1] + ''.join(' %s%s' % (l, format_units(l, u)) for l, u in rec[2]))
+    return '\n'.join(lines) + '\n' if lines else ''
+
+#
+# Round-trip checks
+#
+
+def check_round_trip(text, data):
+    """ Compare a converted file with its source, line by line and value by value """
+    source = [l for l in (r.split(';', 1)[0].strip() for r in text.splitlines()) if l]
+    records = list(read_records(data))
+    if len(source) != len(records):
+        return "line count %d != %d" % (len(source), len(records))
+    for line, rec in zip(source, records):
+        if rec[0] == 'text':
+            if rec[1] != line:
+                return "text changed: %r -> %r" % (line, rec[1])
+            continue
+        code, params = parse_move(line)
+        values = dict(params)
+        if code != rec[1] or sorted(values) != sorted(l for l, _ in rec[2]):
+            return "move changed: %r" % line
+        for letter, units in rec[2]:
+            exact = Fraction(values[letter])
+            if Fraction(units, SCALE[letter]) != exact:
+                return "value changed: %r %s" % (line, letter)
+            if letter != 'F' and not is_nearest_f32(firmware_float(letter, units), exact):
+                return "float differs from strtof: %r %s" % (line, letter)
+    return None
+
+TEST_CASES = [
+    ('G28', 'text'),
+    ('G1 X10 Y20.5 F3000', 'move'),
+    ('G1 X10.001 Y-0.001 Z0.2 E0.03342', 'move'),
+    ('G0 F9000 X100 Y100', 'move'),
+    ('G1X1.5Y2.25E.5', 'move'),
+    ('G1 X-250.125 E-6.5', 'move'),
+    ('G92 E0', 'text'),
+    ('G1 E1234.56789 F1800', 'move'),
+    ('G1 E98765.43210', 'text'),                   # Beyond 30 bits of units
+    ('G1 E9876.5432', 'move'),
+    ('G1 X0.0001', 'text'),                         # Finer than 1 um
+    ('G1 E0.000001', 'text'),                       # Finer than 10 nm
+    ('G1 X1 F1500.5', 'text'),                      # Fractional feedrate
+    ('G1 X1 X2', 'text'),                           # Repeated parameter
+    ('G1 X1 S255', 'text'),                         # Unsupported parameter
+    ('G2 X10 Y10 I5 J0 E1.2', 'move'),
+    ('G3 X-10 Y5 I-5.5 J2.25', 'move'),
+    ('G2 X10 Y10 R5', 'text'),                      # Radius arcs stay text
+    ('G2 X10 I5', 'text'),                          # Arcs need I and J
+    ('G1 X10 ; comment', 'move'),
+    ('; only a comment', None),
+    ('', None),
+    ('G10', 'text'),
+    ('G1.5 X1', 'text'),
+    ('M104 S210', 'text'),
+    ('G1 X16777.217', 'move'),                      # Beyond 24 bits of mantissa
+    ('G1 X123456.789 Y0.1', 'move'),
+    ('G1 X0 Y0 Z0 E0 F0', 'move'),
+    ('G1 X-0.000', 'move'),
+]
+
+def self_test():
+    failed = 0
+    for line, expect in TEST_CASES:
+        data = compile_gcode(line)
+        kind = next(iter(read_records(data)), (None,))[0]
+        problem = check_round_trip(line, data)
+        if kind != expect:
+            problem = "expected %s, got %s" % (expect, kind)
+        if problem:
+            failed += 1
+            print("FAIL %-40r %s" % (line, problem))
+
+    # All cases in one file, to check the deltas between records
+    text = '\n'.join(l for l, _ in TEST_CASES) * 3
+    problem = check_round_trip(text, compile_gcode(text))
+    if problem:
+        failed += 1
+        print("FAIL combined file: " + problem)
+
+    print("%d of %d checks passed" % (len(TEST_CASES) + 1 - failed, len(TEST_CASES) + 1))
+    return failed == 0
+
+parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+parser.add_argument('input', nargs='?', help='G-code file (or .gcb file with --decompile)')
+parser.add_argument('output', nargs='?', help='output file (default=input with .gcb or .gcode extension)')
+parser.add_argument('-d', '--decompile', action='store_true', help='convert a .gcb file back to G-code')
+parser.add_argument('--test', action='store_true', help='run the round-trip self test')
+args = parser.parse_args()
+
+if args.test:
+    sys.exit(0 if self_test() else 1)
+
+if not args.input:
+    parser.error("an input file is required")
+
+with open(args.input, 'rb') as f:
+    data = f.read()
+
+if args.decompile:
+    result = decompile_gcode(data).encode('latin-1')
+    default_ext = '.gcode'
+else:
+    text = data.decode('latin-1')
+    result = compile_gcode(text)
+    problem = check_round_trip(text, result)
+    if problem:
+        sys.exit("Round trip check failed for %s: %s" % (args.input, problem))
+    default_ext = '.gcb'
+
+output = args.output or os.path.splitext(args.input)[0] + default_ext
+with open(output, 'wb') as f:
+    f.write(result)
+
+moves = sum(1 for r in read_records(result if not args.decompile else data) if r[0] == 'move')
+print("%s: %d -> %d bytes, %d binary moves" % (output, len(data), len(result), moves))
@@ -0,0 +1,123 @@
+#!/usr/bin/env python
+
+from __future__ import print_function
+from __future__ import division
+
+""" Compress a G-code file into a .gcz file that Marlin can print directly
+    from the SD card with SD_COMPRESSED_GCODE enabled, or expand a .gcz file
+    back into plain G-code with --decompress.
+
+    The stream is raw heatshrink with the window and lookahead sizes fixed by
+    libs/heatshrink/heatshrink_config.h (8 and 4 bits). """
+
+import argparse
+import os
+import sys
+
+WINDOW_BITS = 8
+LOOKAHEAD_BITS = 4
+WINDOW = 1 << WINDOW_BITS
+LOOKAHEAD = 1 << LOOKAHEAD_BITS
+MIN_MATCH = 2       # A back-reference costs 13 bits, a literal 9
+
+class BitWriter(object):
+    def __init__(self):
+        self.out = bytearray()
+        self.byte = 0
+        self.count = 0
+
+    def put(self, value, bits):
+        for i in range(bits - 1, -1, -1):
+            self.byte = (self.byte << 1) | ((value >> i) & 1)
+            self.count += 1
+            if self.count == 8:
+                self.out.append(self.byte)
+                self.byte = self.count = 0
+
+    def flush(self):
+        # Zero padding reads as an incomplete back-reference and is ignored
+        if self.count:
+            self.out.append(self.byte << (8 - self.count))
+        return bytes(self.out)
+
+class BitReader(object):
+    def __init__(self, data):
+        self.data = bytearray(data)
+        self.pos = 0
+
+    def get(self, bits):
+        if self.pos + bits > len(self.data) * 8:
+            return None
+        value = 0
+        for _ in range(bits):
+            value = (value << 1) | ((self.data[self.pos >> 3] >> (7 - (self.pos & 7))) & 1)
+            self.pos += 1
+        return value
+
+def compress(data):
+    w = BitWriter()
+    i, n = 0, len(data)
+    while i < n:
+        # Longest match that starts in the window; it may run on into the lookahead
+        best_len, best_off = 0, 0
+        length = MIN_MATCH
+        while length <= LOOKAHEAD and i + length <= n:
+            j = data.rfind(data[i:i + length], max(0, i - WINDOW), i + length - 1)
+            if j < 0:
+                break
+            best_len, best_off = length, i - j
+            length += 1
+        if best_len:
+            w.put(0, 1)
+            w.put(best_off - 1, WINDOW_BITS)
+            w.put(best_len - 1, LOOKAHEAD_BITS)
+            i += best_len
+        else:
+            w.put(1, 1)
+            w.put(bytearray(data[i:i + 1])[0], 8)
+            i += 1
+    return w.flush()
+
+def decompress(data):
+    r = BitReader(data)
+    out = bytearray()
+    while True:
+        tag = r.get(1)
+        if tag is None:
+            break
+        if tag:
+            c = r.get(8)
+            if c is None:
+                break
+            out.append(c)
+        else:
+            off, count = r.get(WINDOW_BITS), r.get(LOOKAHEAD_BITS)
+            if off is None or count is None:
+                break
+            for _ in range(count + 1):
+                out.append(out[-(off + 1)] if off < len(out) else 0)
+    return bytes(out)
+
+parser = argparse.ArgumentParser(description=__doc__)
+parser.add_argument('input', help='G-code file (or .gcz file with --decompress)')
+parser.add_argument('output', nargs='?', help='output file (default=input with .gcz or .gcode extension)')
+parser.add_argument('-d', '--decompress', action='store_true', help='expand a .gcz file')
+args = parser.parse_args()
+
+with open(args.input, 'rb') as f:
+    data = f.read()
+
+if args.decompress:
+    result = decompress(data)
+    default_ext = '.gcode'
+else:
+    result = compress(data)
+    if decompress(result) != data:
+        sys.exit("Round trip check failed for " + args.input)
+    default_ext = '.gcz'
+
+output = args.output or os.path.splitext(args.input)[0] + default_ext
+with open(output, 'wb') as f:
+    f.write(result)
+
+print("%s: %d -> %d bytes (%.1f%%)" % (output, len(data), len(result), len(result) * 100 / len(data) if data else 0))
@@ -0,0 +1,120 @@
+#!/usr/bin/env python
+
+from __future__ import print_function
+from __future__ import division
+
+""" Convert a linux_native GPIO trace (gpio_trace.bin, written with
+    GPIO_LOGGING enabled in HAL/LINUX/main.cpp) to CSV or to a VCD file
+    for a waveform viewer such as GTKWave or PulseView. """
+
+import argparse
+import struct
+import sys
+
+parser = argparse.ArgumentParser(description=__doc__)
+parser.add_argument('trace', help='binary trace written by the simulator')
+parser.add_argument('-f', '--format', choices=['csv', 'vcd'], default='csv', help='output format (default=csv)')
+parser.add_argument('-o', '--output', help='output file (default=stdout)')
+parser.add_argument('-p', '--pins', help='comma-separated pin numbers or names to keep (default=all)')
+args = parser.parse_args()
+
+SIGNATURE = b'GPIOTRC\x01'
+EVENTS = ['NOP', 'FALL', 'RISE', 'SET_VALUE', 'SETM', 'SETD']
+SYNC, NAME, DROP = 0xFF, 0xFE, 0xFD
+SET_VALUE, SETM, SETD = 3, 4, 5
+
+def records(path, warn=True):
+    """ Yield (timestamp ns, pin, event, value) for each event and
+        (None, pin, NAME, name) for each pin label. """
+    with open(path, 'rb') as f:
+        if f.read(8) != SIGNATURE:
+            sys.exit('%s is not a GPIO trace' % path)
+        ts = 0
+        while True:
+            rec = f.read(8)
+            if len(rec) < 8:
+                break
+            delta, pin, event, value = struct.unpack('<IBBH', rec)
+            if event == SYNC:
+                ts = delta | value << 32 | pin << 48
+            elif event == NAME:
+                name = f.read((value + 7) & ~7)[:value].decode('ascii', 'replace')
+                yield None, pin, NAME, name
+            elif event == DROP:
+                if warn:
+                    print('warning: %d events dropped before %d ns' % (delta, ts), file=sys.stderr)
+            else:
+                ts += delta
+                yield ts, pin, event, value
+
+def pin_filter(names):
+    if not args.pins:
+        return lambda pin: True
+    keep = set()
+    for p in args.pins.split(','):
+        p = p.strip()
+        if p.isdigit():
+            keep.add(int(p))
+        else:
+            keep.update(pin for pin, name in names.items() if name == p)
+    return lambda pin: pin in keep
+
+def scan(path):
+    """ First pass: pin names, the pins that change, and the ones driven with values > 1 """
+    names, used, analog = {}, set(), set()
+    for ts, pin, event, value in records(path, warn=False):
+        if event == NAME:
+            names[pin] = value
+        elif event < SETM:
+            used.add(pin)
+            if event == SET_VALUE:
+                analog.add(pin)
+    return names, used, analog
+
+def write_csv(out):
+    names = {}
+    out.write('timestamp, pin, event, value, name\n')
+    for ts, pin, event, value in records(args.trace):
+        if event == NAME:
+            names[pin] = value
+            continue
+        if keep(pin):
+            out.write('%d, %d, %s, %d, %s\n' % (ts, pin, EVENTS[event] if event < len(EVENTS) else event, value, names.get(pin, '')))
+
+def vcd_id(n):
+    # Printable short identifiers: !, ", #, ... then two characters
+    chars = ''.join(chr(c) for c in range(33, 127))
+    s = ''
+    while True:
+        s += chars[n % len(chars)]
+        n //= len(chars)
+        if not n:
+            return s
+
+def write_vcd(out):
+    pins = sorted(p for p in used if keep(p))
+    ids = dict((p, vcd_id(i)) for i, p in enumerate(pins))
+    out.write('$comment Marlin linux_native GPIO trace $end\n$timescale 1ns $end\n$scope module marlin $end\n')
+    for p in pins:
+        label = names.get(p, 'pin%d' % p)
+        kind = ('wire', 1) if p not in analog else ('reg', 16)
+        out.write('$var %s %d %s %s $end\n' % (kind + (ids[p], label)))
+    out.write('$upscope $end\n$enddefinitions $end\n')
+    last_ts = None
+    for ts, pin, event, value in records(args.trace):
+        if event == NAME or event >= SETM or pin not in ids:
+            continue
+        if last_ts is None or ts > last_ts:  # Events from different threads may be slightly out of order
+            out.write('#%d\n' % ts)
+            last_ts = ts
+        if pin in analog:
+            out.write('b%s %s\n' % (bin(value)[2:], ids[pin]))
+        else:
+            out.write('%d%s\n' % (1 if value else 0, ids[pin]))
+
+names, used, analog = scan(args.trace)
+keep = pin_filter(names)
+out = open(args.output, 'w') if args.output else sys.stdout
+(write_vcd if args.format == 'vcd' else write_csv)(out)
+if args.output:
+    out.close()
@@ -0,0 +1,73 @@
+#!/usr/bin/env python
+
+from __future__ import print_function
+from __future__ import division
+
+""" Run a G-code corpus through a linux_native build with LINUX_BENCHMARK
+    enabled and collect the per-file results into one JSON document.
+    With --baseline, compare against an earlier run and flag regressions. """
+
+import argparse
+import glob
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+parser = argparse.ArgumentParser(description=__doc__)
+parser.add_argument('firmware', help='linux_native program built with LINUX_BENCHMARK')
+parser.add_argument('corpus', nargs='+', help='G-code files or directories of .gcode files')
+parser.add_argument('-o', '--output', default='benchmark_results.json', help='results file (default=benchmark_results.json)')
+parser.add_argument('-b', '--baseline', help='earlier results file to compare against')
+parser.add_argument('-r', '--result', default='benchmark.json', help='LINUX_BENCHMARK_FILE the firmware was built with (default=benchmark.json)')
+parser.add_argument('-t', '--tolerance', type=float, default=10, help='allowed throughput loss in percent (default=10)')
+args = parser.parse_args()
+
+def corpus_files(paths):
+    for p in paths:
+        if os.path.isdir(p):
+            for f in sorted(glob.glob(os.path.join(p, '*.gcode'))):
+                yield f
+        else:
+            yield p
+
+def run(firmware, gcode):
+    # Each run gets a fresh directory so EEPROM and result files don't leak between runs
+    work = tempfile.mkdtemp(prefix='marlin_bench_')
+    try:
+        with open(gcode, 'rb') as stdin, open(os.devnull, 'wb') as devnull:
+            subprocess.check_call([os.path.abspath(firmware)], stdin=stdin, stdout=devnull, cwd=work)
+        with open(os.path.join(work, args.result)) as f:
+            return json.load(f)
+    finally:
+        shutil.rmtree(work)
+
+results = {}
+for gcode in corpus_files(args.corpus):
+    name = os.path.basename(gcode)
+    r = run(args.firmware, gcode)
+    results[name] = r
+    print("%-32s %10.0f blocks/s %12.0f steps/s  stepper ISR p50 %6d ns p99 %6d ns" % (
+        name, r['blocks_per_s'], r['steps_per_s'], r['stepper_isr']['p50_ns'], r['stepper_isr']['p99_ns']))
+
+with open(args.output, 'w') as f:
+    json.dump(results, f, indent=2, sort_keys=True)
+
+if args.baseline:
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    failed = False
+    for name, r in sorted(results.items()):
+        if name not in baseline:
+            continue
+        for key in ('blocks_per_s', 'steps_per_s'):
+            old, new = baseline[name][key], r[key]
+            change = (new - old) * 100 / old if old else 0
+            flag = ''
+            if change < -args.tolerance:
+                flag = '  REGRESSION'
+                failed = True
+            print("%-32s %-14s %+7.1f%%%s" % (name, key, change, flag))
+    sys.exit(1 if failed else 0)
@@ -0,0 +1,105 @@
+#!/usr/bin/env python
+#
+# step_timer_test.py
+#
+# Host test for STEP_TIMER_TABLE and STEP_TIMER_RECIPROCAL. Builds
+# step_timer_interval() from Marlin/src/module/step_timer_table.h with the
+# host compiler for each timer rate, table size and mode, checks it against
+# STEPPER_TIMER_RATE / step_rate for every step rate in the range, and times
+# both on the host.
+#
+
+from __future__ import print_function
+from __future__ import division
+
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+parser = argparse.ArgumentParser(description='Check step_timer_interval() against the division on the host.')
+parser.add_argument('-t', '--timer', type=int, nargs='+', default=[2000000, 25000000, 42000000, 100000000],
+                    help='STEPPER_TIMER_RATE values to test (default=2000000 25000000 42000000 100000000)')
+parser.add_argument('-s', '--size', type=int, nargs='+', default=[16, 64, 256], help='STEP_TIMER_TABLE_SIZE values (default=16 64 256)')
+parser.add_argument('--min', type=int, default=1, help='lowest step rate (default=1)')
+parser.add_argument('--max', type=int, default=2000000, help='highest step rate (default=2000000)')
+parser.add_argument('--limit', type=int, default=3, help='fail if STEP_TIMER_RECIPROCAL is off by more ticks (default=3)')
+parser.add_argument('--cxx', default=os.environ.get('CXX', 'g++'), help='host C++ compiler (default=$CXX or g++)')
+args = parser.parse_args()
+
+HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', '..', 'Marlin', 'src', 'module', 'step_timer_table.h')
+
+# Just enough of MarlinConfig.h for the header
+CONFIG = r'''
+#pragma once
+#include <stdint.h>
+#define FORCE_INLINE __attribute__((always_inline)) inline
+#define ENABLED(V) (V)
+'''
+
+HARNESS = r'''
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "module/step_timer_table.h"
+
+static uint32_t divide(const uint32_t step_rate) { return (STEPPER_TIMER_RATE) / step_rate; }
+
+int main(int argc, char **argv) {
+  const uint32_t lo = atol(argv[1]), hi = atol(argv[2]);
+
+  uint32_t worst = 0, worst_rate = 0;
+  double ppm = 0;
+  for (uint32_t s = lo; s <= hi; s++) {
+    const uint32_t a = step_timer_interval(s), b = divide(s), d = a > b ? a - b : b - a;
+    if (d > worst) { worst = d; worst_rate = s; }
+    // Relative error beyond the tick that rounding down may cost
+    const double exact = double(STEPPER_TIMER_RATE) / s, e = std::fabs(a - exact) - 1;
+    if (e > 0 && 1e6 * e / exact > ppm) ppm = 1e6 * e / exact;
+  }
+
+  typedef std::chrono::steady_clock clk;
+  volatile uint32_t sink = 0;
+  auto time = [&](uint32_t (*fn)(uint32_t)) {
+    const auto t0 = clk::now();
+    for (uint32_t s = lo; s <= hi; s++) sink = sink + fn(s);
+    return std::chrono::duration<double, std::nano>(clk::now() - t0).count() / (hi - lo + 1);
+  };
+  const double t_div = time(divide), t_table = time(step_timer_interval);
+
+  printf("%u %u %.2f %.2f %.2f\n", worst, worst_rate, ppm, t_div, t_table);
+  return 0;
+}
+'''
+
+work = tempfile.mkdtemp(prefix='marlin_stt_')
+try:
+    os.makedirs(os.path.join(work, 'inc'))
+    os.makedirs(os.path.join(work, 'module'))
+    with open(os.path.join(work, 'inc', 'MarlinConfig.h'), 'w') as f:
+        f.write(CONFIG)
+    shutil.copy(HEADER, os.path.join(work, 'module'))
+    src, exe = os.path.join(work, 'step_timer_test.cpp'), os.path.join(work, 'step_timer_test')
+    with open(src, 'w') as f:
+        f.write(HARNESS)
+
+    print('Step rates %d to %d, against STEPPER_TIMER_RATE / step_rate. Max ppm is the error beyond 1 tick.' % (args.min, args.max))
+    print('%-11s %-7s %-10s %12s %14s %9s %11s' % ('Timer rate', 'Entries', 'Mode', 'Worst ticks', 'at step rate', 'Max ppm', 'ns div/tab'))
+    failed = False
+    for timer in args.timer:
+        for size in args.size:
+            for recip in (0, 1):
+                subprocess.check_call([args.cxx, '-std=c++11', '-O2', '-I', work,
+                                       '-DSTEPPER_TIMER_RATE=%d' % timer, '-DSTEP_TIMER_TABLE_SIZE=%d' % size,
+                                       '-DSTEP_TIMER_RECIPROCAL=%d' % recip, src, '-o', exe])
+                worst, rate, ppm, t_div, t_table = subprocess.check_output([exe, str(args.min), str(args.max)]).split()
+                print('%-11s %-7d %-10s %12s %14s %9s %5s/%-5s' % ('%g MHz' % (timer / 1e6), size,
+                      'Reciprocal' if recip else 'Table', worst.decode(), rate.decode(), ppm.decode(), t_div.decode(), t_table.decode()))
+                if recip and int(worst) > args.limit: failed = True
+    print('This host divides in hardware, so the times only compare the two on it.')
+    sys.exit(1 if failed else 0)
+finally:
+    shutil.rmtree(work)